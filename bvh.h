@@ -0,0 +1,399 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "frustum.h"
+
+// Ієрархія обмежувальних об'ємів над світовими AABB об'єктів сцени.
+// Побудова - binned SAH (12 кошиків на вісь), оновлення рухомих об'єктів - refit без перебудови.
+// Запити (видимість, промінь, перетин з боксом/сферою) коштують пропорційно до зачеплених вузлів,
+// а не до кількості об'єктів
+class BVH
+{
+    public:
+        static const int BIN_COUNT = 12;
+        static const uint32_t MAX_LEAF_SIZE = 4;
+        // Глибше вузли не діляться (лист може бути більшим за MAX_LEAF_SIZE) - так обхід
+        // у глибину вміщається в стек фіксованого розміру: на кожному рівні лишається
+        // щонайбільше один відкладений сусід
+        static const uint32_t MAX_DEPTH = 48;
+        static const int STACK_SIZE = MAX_DEPTH + 2;
+        static const uint32_t INVALID = 0xFFFFFFFFu;
+
+        // Вузол: у листі count > 0 і first - перший індекс в objectIndices,
+        // у внутрішньому count == 0 і first - лівий нащадок (правий - first + 1)
+        struct Node
+        {
+            AABB bounds;
+            uint32_t first;
+            uint32_t count;
+        };
+
+        struct RayHit
+        {
+            uint32_t object = INVALID;
+            float distance = 0.0f;
+        };
+
+        // Повна перебудова з масиву меж (індекс у масиві = індекс об'єкта в запитах)
+        void build(const std::vector<AABB>& bounds)
+        {
+            objectBounds = bounds;
+            objectIndices.resize(bounds.size());
+            centroids.resize(bounds.size());
+            for (size_t i = 0; i < bounds.size(); ++i)
+            {
+                objectIndices[i] = static_cast<uint32_t>(i);
+                centroids[i] = bounds[i].center();
+            }
+
+            nodes.clear();
+            if (bounds.empty())
+                return;
+
+            nodes.reserve(bounds.size() * 2);
+            nodes.push_back({AABB::empty(), 0, static_cast<uint32_t>(bounds.size())});
+            updateNodeBounds(0);
+            subdivide(0, 0);
+        }
+
+        // Новий бокс об'єкта; ієрархія оновиться при наступному refit()
+        void update(uint32_t object, const AABB& bounds)
+        {
+            objectBounds[object] = bounds;
+        }
+
+        // Перерахунок меж знизу вгору. Нащадки завжди мають більший індекс за батька,
+        // тож достатньо одного зворотного проходу. Якість дерева падає, якщо об'єкти
+        // розлітаються далеко - тоді варто викликати build()
+        void refit()
+        {
+            for (size_t i = nodes.size(); i-- > 0;)
+            {
+                Node& node = nodes[i];
+                if (node.count > 0)
+                {
+                    updateNodeBounds(static_cast<uint32_t>(i));
+                }
+                else
+                {
+                    node.bounds = nodes[node.first].bounds;
+                    node.bounds.expand(nodes[node.first + 1].bounds);
+                }
+            }
+        }
+
+        size_t size() const
+        {
+            return objectBounds.size();
+        }
+
+        const std::vector<Node>& nodeList() const
+        {
+            return nodes;
+        }
+
+        // Видимі об'єкти; піддерева, що повністю всередині, додаються без перевірок
+        void cull(const Frustum& frustum, std::vector<uint32_t>& visible) const
+        {
+            visible.clear();
+            if (nodes.empty())
+                return;
+
+            uint32_t stack[STACK_SIZE];
+            int stackSize = 0;
+            stack[stackSize++] = 0;
+
+            while (stackSize > 0)
+            {
+                const Node& node = nodes[stack[--stackSize]];
+                Frustum::Containment containment = frustum.classify(node.bounds);
+                if (containment == Frustum::OUTSIDE)
+                    continue;
+
+                if (containment == Frustum::INSIDE)
+                {
+                    appendSubtree(node, visible);
+                    continue;
+                }
+
+                if (node.count > 0)
+                {
+                    for (uint32_t i = 0; i < node.count; ++i)
+                    {
+                        uint32_t object = objectIndices[node.first + i];
+                        if (frustum.intersects(objectBounds[object]))
+                            visible.push_back(object);
+                    }
+                    continue;
+                }
+
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = node.first + 1;
+            }
+        }
+
+        // Найближчий об'єкт уздовж променя (напр. вибір об'єкта з камери)
+        RayHit raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = 1.0e30f) const
+        {
+            RayHit hit;
+            if (nodes.empty())
+                return hit;
+
+            glm::vec3 inverseDirection = glm::vec3(1.0f) / direction;
+            float closest = maxDistance;
+
+            uint32_t stack[STACK_SIZE];
+            int stackSize = 0;
+            stack[stackSize++] = 0;
+
+            while (stackSize > 0)
+            {
+                const Node& node = nodes[stack[--stackSize]];
+                float entry;
+                if (!intersectRay(node.bounds, origin, inverseDirection, closest, entry))
+                    continue;
+
+                if (node.count > 0)
+                {
+                    for (uint32_t i = 0; i < node.count; ++i)
+                    {
+                        uint32_t object = objectIndices[node.first + i];
+                        if (intersectRay(objectBounds[object], origin, inverseDirection, closest, entry))
+                        {
+                            closest = entry;
+                            hit.object = object;
+                            hit.distance = entry;
+                        }
+                    }
+                    continue;
+                }
+
+                // Ближчий нащадок обходиться першим, щоб швидше звузити closest
+                uint32_t leftChild = node.first;
+                uint32_t rightChild = node.first + 1;
+                float leftEntry, rightEntry;
+                bool leftHit = intersectRay(nodes[leftChild].bounds, origin, inverseDirection, closest, leftEntry);
+                bool rightHit = intersectRay(nodes[rightChild].bounds, origin, inverseDirection, closest, rightEntry);
+                if (leftHit && rightHit)
+                {
+                    bool leftFirst = leftEntry <= rightEntry;
+                    stack[stackSize++] = leftFirst ? rightChild : leftChild;
+                    stack[stackSize++] = leftFirst ? leftChild : rightChild;
+                }
+                else if (leftHit)
+                {
+                    stack[stackSize++] = leftChild;
+                }
+                else if (rightHit)
+                {
+                    stack[stackSize++] = rightChild;
+                }
+            }
+            return hit;
+        }
+
+        // Об'єкти, межі яких перетинають бокс
+        void query(const AABB& box, std::vector<uint32_t>& result) const
+        {
+            result.clear();
+            if (nodes.empty())
+                return;
+
+            uint32_t stack[STACK_SIZE];
+            int stackSize = 0;
+            stack[stackSize++] = 0;
+
+            while (stackSize > 0)
+            {
+                const Node& node = nodes[stack[--stackSize]];
+                if (!node.bounds.overlaps(box))
+                    continue;
+
+                if (node.count > 0)
+                {
+                    for (uint32_t i = 0; i < node.count; ++i)
+                    {
+                        uint32_t object = objectIndices[node.first + i];
+                        if (objectBounds[object].overlaps(box))
+                            result.push_back(object);
+                    }
+                    continue;
+                }
+
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = node.first + 1;
+            }
+        }
+
+        // Об'єкти в радіусі дії точкового світла
+        void query(const glm::vec3& center, float radius, std::vector<uint32_t>& result) const
+        {
+            query(AABB{center - glm::vec3(radius), center + glm::vec3(radius)}, result);
+
+            // Відсіювання кутів куба, що не дістають до сфери
+            float radiusSquared = radius * radius;
+            result.erase(std::remove_if(result.begin(), result.end(), [&](uint32_t object) {
+                glm::vec3 closest = glm::clamp(center, objectBounds[object].min, objectBounds[object].max);
+                glm::vec3 d = closest - center;
+                return glm::dot(d, d) > radiusSquared;
+            }), result.end());
+        }
+
+    private:
+        std::vector<Node> nodes;
+        std::vector<AABB> objectBounds;
+        std::vector<uint32_t> objectIndices;
+        std::vector<glm::vec3> centroids;
+
+        struct Bin
+        {
+            AABB bounds = AABB::empty();
+            uint32_t count = 0;
+        };
+
+        void updateNodeBounds(uint32_t nodeIndex)
+        {
+            Node& node = nodes[nodeIndex];
+            node.bounds = AABB::empty();
+            for (uint32_t i = 0; i < node.count; ++i)
+            {
+                node.bounds.expand(objectBounds[objectIndices[node.first + i]]);
+            }
+        }
+
+        // Найдешевший за SAH розріз: вісь, позиція і ціна
+        float findBestSplit(const Node& node, int& bestAxis, float& bestPosition) const
+        {
+            float bestCost = 1.0e30f;
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                float boundsMin = 1.0e30f, boundsMax = -1.0e30f;
+                for (uint32_t i = 0; i < node.count; ++i)
+                {
+                    float c = centroids[objectIndices[node.first + i]][axis];
+                    boundsMin = std::min(boundsMin, c);
+                    boundsMax = std::max(boundsMax, c);
+                }
+                if (boundsMin == boundsMax)
+                    continue;
+
+                Bin bins[BIN_COUNT];
+                float scale = BIN_COUNT / (boundsMax - boundsMin);
+                for (uint32_t i = 0; i < node.count; ++i)
+                {
+                    uint32_t object = objectIndices[node.first + i];
+                    int bin = std::min(BIN_COUNT - 1, static_cast<int>((centroids[object][axis] - boundsMin) * scale));
+                    bins[bin].count++;
+                    bins[bin].bounds.expand(objectBounds[object]);
+                }
+
+                // Префіксні суми зліва і справа для кожної з BIN_COUNT - 1 площин
+                float leftArea[BIN_COUNT - 1], rightArea[BIN_COUNT - 1];
+                uint32_t leftCount[BIN_COUNT - 1], rightCount[BIN_COUNT - 1];
+                AABB leftBox = AABB::empty(), rightBox = AABB::empty();
+                uint32_t leftSum = 0, rightSum = 0;
+                for (int i = 0; i < BIN_COUNT - 1; ++i)
+                {
+                    leftSum += bins[i].count;
+                    leftCount[i] = leftSum;
+                    leftBox.expand(bins[i].bounds);
+                    leftArea[i] = leftBox.surfaceArea();
+
+                    rightSum += bins[BIN_COUNT - 1 - i].count;
+                    rightCount[BIN_COUNT - 2 - i] = rightSum;
+                    rightBox.expand(bins[BIN_COUNT - 1 - i].bounds);
+                    rightArea[BIN_COUNT - 2 - i] = rightBox.surfaceArea();
+                }
+
+                for (int i = 0; i < BIN_COUNT - 1; ++i)
+                {
+                    if (leftCount[i] == 0 || rightCount[i] == 0)
+                        continue;
+                    float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestPosition = boundsMin + (i + 1) / scale;
+                    }
+                }
+            }
+            return bestCost;
+        }
+
+        void subdivide(uint32_t nodeIndex, uint32_t depth)
+        {
+            if (nodes[nodeIndex].count <= MAX_LEAF_SIZE || depth >= MAX_DEPTH)
+                return;
+
+            int axis = -1;
+            float position = 0.0f;
+            float splitCost = findBestSplit(nodes[nodeIndex], axis, position);
+
+            // Лишаємо листом, якщо розріз не дешевший за перевірку всіх об'єктів вузла
+            float leafCost = nodes[nodeIndex].count * nodes[nodeIndex].bounds.surfaceArea();
+            if (axis < 0 || splitCost >= leafCost)
+                return;
+
+            Node& node = nodes[nodeIndex];
+            uint32_t* begin = objectIndices.data() + node.first;
+            uint32_t* end = begin + node.count;
+            uint32_t* middle = std::partition(begin, end, [&](uint32_t object) {
+                return centroids[object][axis] < position;
+            });
+
+            uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+            if (leftCount == 0 || leftCount == node.count)
+                return;
+
+            uint32_t leftChild = static_cast<uint32_t>(nodes.size());
+            uint32_t first = node.first;
+            uint32_t count = node.count;
+            nodes.push_back({AABB::empty(), first, leftCount});
+            nodes.push_back({AABB::empty(), first + leftCount, count - leftCount});
+
+            // push_back міг перевиділити пам'ять - посилання node вже недійсне
+            nodes[nodeIndex].first = leftChild;
+            nodes[nodeIndex].count = 0;
+
+            updateNodeBounds(leftChild);
+            updateNodeBounds(leftChild + 1);
+            subdivide(leftChild, depth + 1);
+            subdivide(leftChild + 1, depth + 1);
+        }
+
+        void appendSubtree(const Node& root, std::vector<uint32_t>& visible) const
+        {
+            if (root.count > 0)
+            {
+                visible.insert(visible.end(), objectIndices.begin() + root.first,
+                               objectIndices.begin() + root.first + root.count);
+                return;
+            }
+            appendSubtree(nodes[root.first], visible);
+            appendSubtree(nodes[root.first + 1], visible);
+        }
+
+        // Slab-тест; entry - відстань входу (0, якщо початок променя всередині)
+        static bool intersectRay(const AABB& box, const glm::vec3& origin, const glm::vec3& inverseDirection,
+                                 float maxDistance, float& entry)
+        {
+            glm::vec3 t0 = (box.min - origin) * inverseDirection;
+            glm::vec3 t1 = (box.max - origin) * inverseDirection;
+            glm::vec3 tNear = glm::min(t0, t1);
+            glm::vec3 tFar = glm::max(t0, t1);
+            float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+            float exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+            entry = enter;
+            return enter <= exit && enter < maxDistance;
+        }
+};
+
+#endif
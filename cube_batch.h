@@ -0,0 +1,296 @@
+#ifndef CUBE_BATCH_H
+#define CUBE_BATCH_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "texture.h"
+#include "material.h"
+#include "mesh.h"
+#include "depth_sort.h"
+
+// Дані одного інстансу куба (vertex_shader_instanced.vs, locations 4-6)
+struct CubeInstance
+{
+    glm::vec3 position;
+    glm::vec3 size;
+    unsigned int materialIndex;   // індекс у MaterialBuffer
+};
+
+namespace Semantic
+{
+    struct InstancePosition
+    {
+        static constexpr GLuint location = 4;
+        static constexpr const char* name = "instancePosition";
+        static const glm::vec3& get(const CubeInstance& instance) { return instance.position; }
+    };
+
+    struct InstanceSize
+    {
+        static constexpr GLuint location = 5;
+        static constexpr const char* name = "instanceSize";
+        static const glm::vec3& get(const CubeInstance& instance) { return instance.size; }
+    };
+
+    struct InstanceMaterial
+    {
+        static constexpr GLuint location = 6;
+        static constexpr const char* name = "instanceMaterial";
+        static unsigned int get(const CubeInstance& instance) { return instance.materialIndex; }
+    };
+}
+
+// Буфер інстансів - масив CubeInstance як є, тому розкладка має збігатися зі структурою
+using CubeInstanceLayout = VertexLayout<Attr<Semantic::InstancePosition, AttribFormat::Float3>,
+                                        Attr<Semantic::InstanceSize, AttribFormat::Float3>,
+                                        Attr<Semantic::InstanceMaterial, AttribFormat::Uint1>>;
+
+static_assert(CubeInstanceLayout::stride == sizeof(CubeInstance), "CubeInstanceLayout must match CubeInstance");
+static_assert(CubeInstanceLayout::offsets[1] == offsetof(CubeInstance, size) &&
+              CubeInstanceLayout::offsets[2] == offsetof(CubeInstance, materialIndex),
+              "CubeInstanceLayout must match CubeInstance");
+
+// Дескриптори uniform-змінних пакета
+struct CubeBatchUniforms
+{
+    Uniform<glm::vec3> viewPos;
+    Uniform<glm::mat4> view;
+    Uniform<glm::mat4> projection;
+    Uniform<bool> useTextures;
+    std::vector<Uniform<int>> textureSamplers;
+
+    CubeBatchUniforms() = default;
+
+    CubeBatchUniforms(const Shader& shader, size_t textureCount)
+    : viewPos(shader.uniform<glm::vec3>("viewPos")),
+      view(shader.uniform<glm::mat4>("view")),
+      projection(shader.uniform<glm::mat4>("projection")),
+      useTextures(shader.uniform<bool>("useTextures"))
+    {
+        for (size_t i = 0; i < textureCount; ++i)
+        {
+            textureSamplers.push_back(shader.uniform<int>("texture" + std::to_string(i)));
+        }
+    }
+};
+
+// Пакет кубів, що малюється одним glDrawElementsInstanced.
+// Один одиничний куб (VBO + IndexBuffer) на весь пакет + буфер інстансів з позицією, розміром і матеріалом
+class CubeBatch : public Mesh
+{
+    public:
+        unsigned int VAO, VBO, instanceVBO;
+        IndexBuffer indexBuffer;
+        Shader& shader;
+        std::vector<Texture*> textures;
+        // Шейдер з TEXTURE_ARRAY: шар береться з матеріалу інстансу, textures порожній
+        TextureArray* textureArray = nullptr;
+        bool showTex;
+
+        // Інстанси малюються ззаду наперед (порядок інстансів = порядок растеризації)
+        bool depthSorted;
+
+        CubeBatch(Shader& shaderRef, const std::vector<Texture*>& texs, bool showTex = true,
+                  bool depthSorted = false)
+        : shader(shaderRef), textures(texs), showTex(showTex), depthSorted(depthSorted)
+        {
+            uniforms = CubeBatchUniforms(shader, textures.size());
+            inputValid = validateVertexInput<CubeLayout, CubeInstanceLayout>(shader, "CUBE_BATCH");
+
+            // Одиничний куб з центром у початку координат - трансформація лише з інстансу
+            MeshGeometry cube = Cube::buildGeometry(glm::vec3(1.0f), glm::vec3(1.0f));
+            std::vector<unsigned char> packed = CubeLayout::pack(cube.vertices);
+
+            glGenVertexArrays(1, &VAO);
+            glGenBuffers(1, &VBO);
+            glGenBuffers(1, &instanceVBO);
+
+            glBindVertexArray(VAO);
+
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+
+            indexBuffer.upload(cube.indices, cube.vertices.size());
+
+            CubeLayout::setup();
+
+            // Атрибути інстансу (divisor = 1)
+            glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+            CubeInstanceLayout::setup(1);
+
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        // Повертає індекс інстансу в пакеті
+        size_t add(const glm::vec3& position, const glm::vec3& size, unsigned int materialIndex)
+        {
+            instances.push_back({position, size, materialIndex});
+            dirty = true;
+            return instances.size() - 1;
+        }
+
+        void update(size_t index, const CubeInstance& instance)
+        {
+            instances[index] = instance;
+            dirty = true;
+        }
+
+        void clear()
+        {
+            instances.clear();
+            dirty = true;
+        }
+
+        size_t size() const
+        {
+            return instances.size();
+        }
+
+        // Програма для проходу з іншим варіантом шейдера (RenderContext::variant).
+        // Входи вершин і інстансу мають збігатися з основною програмою - VAO спільний
+        void setVariant(ShaderVariant variantId, Shader& variantShader)
+        {
+            variants[static_cast<int>(variantId)] = {
+                &variantShader, CubeBatchUniforms(variantShader, textures.size()),
+                validateVertexInput<CubeLayout, CubeInstanceLayout>(variantShader, "CUBE_BATCH")};
+        }
+
+        // Таблиця матеріалів (MaterialBuffer) має бути прив'язана до MATERIAL_BUFFER_BINDING
+        void draw(RenderContext& context) override
+        {
+            ProgramVariant& variant = variants[static_cast<int>(context.variant)];
+            // Програма не читає CubeLayout / CubeInstanceLayout - помилка вже в журналі
+            if (instances.empty() || !(variant.shader ? variant.inputValid : inputValid))
+                return;
+
+            // Weighted blended OIT не залежить від порядку - сортування лише для звичайного змішування
+            if (depthSorted && context.variant != ShaderVariant::OIT)
+            {
+                sortInstances(context);
+            }
+            else
+            {
+                if (dirty)
+                    uploadedSorted = false;
+                uploadInstances(instances);
+            }
+
+            GLStateCache& state = context.state;
+            Shader& program = variant.shader ? *variant.shader : shader;
+            CubeBatchUniforms& programUniforms = variant.shader ? variant.uniforms : uniforms;
+
+            state.useProgram(program.ID);
+
+            if (state.firstUseThisFrame(program.ID))
+            {
+                programUniforms.viewPos.set(context.viewPos);
+                programUniforms.view.set(context.view);
+                programUniforms.projection.set(context.projection);
+
+                for (unsigned int i = 0; i < programUniforms.textureSamplers.size(); i++)
+                {
+                    programUniforms.textureSamplers[i].set(static_cast<int>(i));
+                }
+            }
+
+            bool hasTextures = !textures.empty() || textureArray;
+            programUniforms.useTextures.set(hasTextures && showTex);
+
+            if (textureArray)
+            {
+                state.bindTexture(TEXTURE_ARRAY_UNIT, textureArray->ID, GL_TEXTURE_2D_ARRAY, textureArray->sampler);
+            }
+            for (unsigned int i = 0; i < textures.size(); i++)
+            {
+                state.bindTexture(i, textures[i]->ID, GL_TEXTURE_2D, textures[i]->sampler);
+            }
+
+            state.bindVertexArray(VAO);
+            glDrawElementsInstanced(GL_TRIANGLES, indexBuffer.count, indexBuffer.type, 0,
+                                    static_cast<GLsizei>(instances.size()));
+            state.stats.drawCalls++;
+        }
+
+        ~CubeBatch() override
+        {
+            glDeleteVertexArrays(1, &VAO);
+            glDeleteBuffers(1, &VBO);
+            glDeleteBuffers(1, &instanceVBO);
+        }
+
+        CubeBatch(const CubeBatch&) = delete;
+        CubeBatch& operator=(const CubeBatch&) = delete;
+
+    private:
+        std::vector<CubeInstance> instances;
+        CubeBatchUniforms uniforms;
+        struct ProgramVariant
+        {
+            Shader* shader = nullptr;
+            CubeBatchUniforms uniforms;
+            bool inputValid = false;
+        };
+        ProgramVariant variants[SHADER_VARIANT_COUNT];
+        bool inputValid = false;
+        size_t instanceCapacity = 0;
+        bool dirty = false;
+        // У буфері інстансів порядок sorter, а не порядок instances
+        bool uploadedSorted = false;
+
+        DepthSorter sorter;
+        std::vector<glm::vec3> centers;
+        std::vector<CubeInstance> sortedInstances;
+
+        // Перезавантаження буфера інстансів лише коли змінились дані або порядок
+        void sortInstances(RenderContext& context)
+        {
+            centers.resize(instances.size());
+            for (size_t i = 0; i < instances.size(); ++i)
+            {
+                centers[i] = instances[i].position;
+            }
+
+            const std::vector<uint32_t>& order = sorter.sort(centers, context.view);
+            context.state.stats.depthSortSwaps += static_cast<unsigned int>(sorter.lastSwaps());
+
+            if (sorter.lastSwaps() == 0 && !dirty && uploadedSorted)
+                return;
+
+            sortedInstances.resize(instances.size());
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                sortedInstances[i] = instances[order[i]];
+            }
+
+            dirty = true;
+            uploadInstances(sortedInstances);
+            uploadedSorted = true;
+        }
+
+        void uploadInstances(const std::vector<CubeInstance>& data)
+        {
+            if (!dirty)
+                return;
+
+            glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+            if (data.size() > instanceCapacity)
+            {
+                instanceCapacity = data.size();
+                glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(CubeInstance), data.data(), GL_DYNAMIC_DRAW);
+            }
+            else
+            {
+                glBufferSubData(GL_ARRAY_BUFFER, 0, data.size() * sizeof(CubeInstance), data.data());
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            dirty = false;
+        }
+};
+
+#endif
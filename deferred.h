@@ -0,0 +1,260 @@
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "render_state.h"
+
+// Tiled deferred shading - альтернатива прямому конвеєру для непрозорих об'єктів.
+// Геометричний прохід (fragment_shader_gbuffer.fs) пише компактний G-буфер:
+//   albedo + ao (RGBA8), октаедрична нормаль + metallic + roughness (RGBA16F),
+//   колір текстур (RGBA8), глибина (DEPTH24_STENCIL8).
+// Далі compute-шейдер (compute_shader_deferred.cs) для кожного тайла 16x16 відбирає джерела
+// світла і освітлює кожен піксель один раз, незалежно від перекриття геометрії.
+// Прозорі об'єкти малюються після цього прямим конвеєром поверх перенесеної глибини
+class DeferredRenderer
+{
+    public:
+        static const int TILE_SIZE = 16;
+        // Довжина списку джерел тайла (MAX_TILE_LIGHTS у compute_shader_deferred.cs)
+        static const unsigned int MAX_TILE_LIGHTS = 1024;
+        // Точка прив'язки SSBO з лічильниками переповнення (layout(binding = 5))
+        static const GLuint TILE_STATS_BINDING = 5;
+
+        unsigned int gBufferFBO, albedoTexture, normalTexture, tintTexture, depthTexture;
+        unsigned int outputFBO, outputTexture;
+        Shader& lightingShader;
+
+        // Колір пікселів без геометрії (як glClearColor прямого конвеєра)
+        glm::vec3 clearColor = glm::vec3(0.1f);
+
+        DeferredRenderer(Shader& lightingRef, int width, int height)
+        : lightingShader(lightingRef)
+        {
+            uniforms.view = lightingShader.uniform<glm::mat4>("view");
+            uniforms.projection = lightingShader.uniform<glm::mat4>("projection");
+            uniforms.inverseViewProjection = lightingShader.uniform<glm::mat4>("inverseViewProjection");
+            uniforms.viewPos = lightingShader.uniform<glm::vec3>("viewPos");
+            uniforms.nearPlane = lightingShader.uniform<float>("nearPlane");
+            uniforms.farPlane = lightingShader.uniform<float>("farPlane");
+            uniforms.clearColor = lightingShader.uniform<glm::vec3>("clearColor");
+
+            glGenBuffers(STATS_FRAMES, statsBuffers);
+            for (int i = 0; i < STATS_FRAMES; ++i)
+            {
+                glBindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffers[i]);
+                glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(TileStats), nullptr, GL_DYNAMIC_READ);
+            }
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+            glGenFramebuffers(1, &gBufferFBO);
+            glGenFramebuffers(1, &outputFBO);
+            glGenTextures(1, &albedoTexture);
+            glGenTextures(1, &normalTexture);
+            glGenTextures(1, &tintTexture);
+            glGenTextures(1, &depthTexture);
+            glGenTextures(1, &outputTexture);
+
+            resize(width, height);
+        }
+
+        // Перестворення G-буфера під новий розмір кадру. Прив'язує текстури напряму,
+        // тому викликається до GLStateCache::beginFrame()
+        void resize(int newWidth, int newHeight)
+        {
+            if (newWidth == width && newHeight == height)
+                return;
+            if (newWidth <= 0 || newHeight <= 0)
+                return;
+
+            width = newWidth;
+            height = newHeight;
+
+            allocateTarget(albedoTexture, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+            allocateTarget(normalTexture, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+            allocateTarget(tintTexture, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+            allocateTarget(depthTexture, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8);
+            allocateTarget(outputTexture, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, gBufferFBO);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedoTexture, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalTexture, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, tintTexture, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+
+            const GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
+            glDrawBuffers(3, drawBuffers);
+
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            {
+                std::cout << "ERROR::DEFERRED::GBUFFER_NOT_COMPLETE" << std::endl;
+            }
+
+            // Результат освітлення - окремий FBO лише для копіювання у вікно
+            glBindFramebuffer(GL_FRAMEBUFFER, outputFBO);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, outputTexture, 0);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            {
+                std::cout << "ERROR::DEFERRED::OUTPUT_NOT_COMPLETE" << std::endl;
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+        // Початок геометричного проходу: далі малюються непрозорі об'єкти G-буферними шейдерами
+        void beginGeometry()
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, gBufferFBO);
+
+            const float zero[] = {0.0f, 0.0f, 0.0f, 0.0f};
+            const float one = 1.0f;
+            glClearBufferfv(GL_COLOR, 0, zero);
+            glClearBufferfv(GL_COLOR, 1, zero);
+            glClearBufferfv(GL_COLOR, 2, zero);
+            glClearBufferfv(GL_DEPTH, 0, &one);
+
+            // Змішування пошкодило б атрибути поверхні
+            glDisable(GL_BLEND);
+        }
+
+        // Освітлення по тайлах і перенесення результату та глибини у вікно
+        void shade(RenderContext& context, float nearPlane, float farPlane)
+        {
+            glEnable(GL_BLEND);
+
+            GLStateCache& state = context.state;
+            state.useProgram(lightingShader.ID);
+            uniforms.view.set(context.view);
+            uniforms.projection.set(context.projection);
+            uniforms.inverseViewProjection.set(glm::inverse(context.projection * context.view));
+            uniforms.viewPos.set(context.viewPos);
+            uniforms.nearPlane.set(nearPlane);
+            uniforms.farPlane.set(farPlane);
+            uniforms.clearColor.set(clearColor);
+
+            state.bindTexture(0, albedoTexture);
+            state.bindTexture(1, normalTexture);
+            state.bindTexture(2, tintTexture);
+            state.bindTexture(3, depthTexture);
+            glBindImageTexture(0, outputTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+            // Лічильники кадру - у буфер, з якого читали STATS_FRAMES кадрів тому
+            readStats();
+            state.stats.tileLightOverflows = lastStats.overflowTiles;
+            state.stats.maxTileLights = lastStats.maxTileLights;
+            const GLuint zero = 0;
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffers[currentStats]);
+            glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TILE_STATS_BINDING, statsBuffers[currentStats]);
+
+            glDispatchCompute((width + TILE_SIZE - 1) / TILE_SIZE, (height + TILE_SIZE - 1) / TILE_SIZE, 1);
+            state.stats.drawCalls++;
+
+            statsFences[currentStats] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            currentStats = (currentStats + 1) % STATS_FRAMES;
+
+            // Запис через image store має бути видимий для glBlitFramebuffer
+            glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT);
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, outputFBO);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+            // Глибина для прозорих об'єктів, що малюються далі прямим конвеєром
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, gBufferFBO);
+            glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+        ~DeferredRenderer()
+        {
+            glDeleteFramebuffers(1, &gBufferFBO);
+            glDeleteFramebuffers(1, &outputFBO);
+            glDeleteTextures(1, &albedoTexture);
+            glDeleteTextures(1, &normalTexture);
+            glDeleteTextures(1, &tintTexture);
+            glDeleteTextures(1, &depthTexture);
+            glDeleteTextures(1, &outputTexture);
+            glDeleteBuffers(STATS_FRAMES, statsBuffers);
+            for (GLsync fence : statsFences)
+            {
+                if (fence)
+                    glDeleteSync(fence);
+            }
+        }
+
+        DeferredRenderer(const DeferredRenderer&) = delete;
+        DeferredRenderer& operator=(const DeferredRenderer&) = delete;
+
+    private:
+        struct LightingUniforms
+        {
+            Uniform<glm::mat4> view;
+            Uniform<glm::mat4> projection;
+            Uniform<glm::mat4> inverseViewProjection;
+            Uniform<glm::vec3> viewPos;
+            Uniform<float> nearPlane;
+            Uniform<float> farPlane;
+            Uniform<glm::vec3> clearColor;
+        };
+
+        // Буфери лічильників кількох кадрів по колу, щоб читання не чекало на GPU
+        static const int STATS_FRAMES = 3;
+
+        struct TileStats
+        {
+            GLuint overflowTiles = 0;
+            GLuint maxTileLights = 0;
+        };
+
+        int width = 0;
+        int height = 0;
+        LightingUniforms uniforms;
+        GLuint statsBuffers[STATS_FRAMES];
+        GLsync statsFences[STATS_FRAMES] = {};
+        int currentStats = 0;
+        TileStats lastStats;
+
+        // Лічильники найстарішого кадру, якщо GPU вже закінчив його. Переповнення - в журнал
+        // лише на початку: список тайла обрізано, частину світла в тайлі не видно
+        void readStats()
+        {
+            GLsync& fence = statsFences[currentStats];
+            if (!fence)
+                return;
+            // Не готовий - кадр пропускаємо, буфер зараз перезапишеться
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            glDeleteSync(fence);
+            fence = 0;
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                return;
+
+            bool wasOverflowing = lastStats.overflowTiles > 0;
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffers[currentStats]);
+            glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(TileStats), &lastStats);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+            if (lastStats.overflowTiles > 0 && !wasOverflowing)
+            {
+                std::cout << "ERROR::DEFERRED::TILE_LIGHT_OVERFLOW " << lastStats.overflowTiles << " tiles, up to "
+                          << lastStats.maxTileLights << " lights (limit " << MAX_TILE_LIGHTS << ")" << std::endl;
+            }
+        }
+
+        void allocateTarget(unsigned int texture, GLint internalFormat, GLenum format, GLenum type)
+        {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+};
+
+#endif
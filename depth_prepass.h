@@ -0,0 +1,155 @@
+#ifndef DEPTH_PREPASS_H
+#define DEPTH_PREPASS_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "mesh.h"
+#include "render_state.h"
+
+// Глибинний прохід для непрозорих об'єктів прямого конвеєра.
+// Спершу меші малюються лише в буфер глибини (vertex_shader_depth.vs, без фрагментного шейдера),
+// далі PBR-прохід іде з GL_EQUAL і вимкненим записом глибини - дорогий цикл calculateLight
+// виконується раз на видимий піксель, а не для кожного растеризованого фрагмента.
+// Перекриття міряється запитами GL_SAMPLES_PASSED; результати читаються без очікування,
+// тому статистика відстає на кадр-два
+class DepthPrepass
+{
+    public:
+        Shader& depthShader;
+
+        // false - лише вимірювання PBR-проходу, без глибинного проходу (для порівняння)
+        bool enabled = true;
+
+        DepthPrepass(Shader& depthRef)
+        : depthShader(depthRef)
+        {
+            uniforms.model = depthShader.uniform<glm::mat4>("model");
+            uniforms.view = depthShader.uniform<glm::mat4>("view");
+            uniforms.projection = depthShader.uniform<glm::mat4>("projection");
+
+            glGenQueries(QUERY_FRAMES, prepassQueries);
+            glGenQueries(QUERY_FRAMES, shadingQueries);
+        }
+
+        // Глибинний прохід (якщо увімкнений) і стан для PBR-проходу.
+        // meshes - непрозорі меші в порядку подачі (RenderQueue::collect)
+        void begin(RenderContext& context, const std::vector<Mesh*>& meshes)
+        {
+            readResults();
+            context.state.stats.shadedFragments = shadedFragments;
+            context.state.stats.overdrawSaved = overdrawSaved;
+
+            slot.prepassMeasured = enabled;
+            if (enabled)
+            {
+                GLStateCache& state = context.state;
+                state.useProgram(depthShader.ID);
+                if (state.firstUseThisFrame(depthShader.ID))
+                {
+                    uniforms.view.set(context.view);
+                    uniforms.projection.set(context.projection);
+                }
+
+                glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                glBeginQuery(GL_SAMPLES_PASSED, prepassQueries[current]);
+                for (Mesh* mesh : meshes)
+                {
+                    uniforms.model.set(mesh->vertexMatrix());
+                    mesh->drawGeometry(context);
+                }
+                glEndQuery(GL_SAMPLES_PASSED);
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+                // Глибина вже остаточна: PBR-прохід лише читає її
+                glDepthFunc(GL_EQUAL);
+                glDepthMask(GL_FALSE);
+            }
+
+            glBeginQuery(GL_SAMPLES_PASSED, shadingQueries[current]);
+        }
+
+        // Після PBR-проходу непрозорих: стандартний тест глибини для прозорих
+        void end(RenderContext& /*context*/)
+        {
+            glEndQuery(GL_SAMPLES_PASSED);
+
+            if (slot.prepassMeasured)
+            {
+                glDepthFunc(GL_LESS);
+                glDepthMask(GL_TRUE);
+            }
+
+            slots[current] = slot;
+            slots[current].pending = true;
+            current = (current + 1) % QUERY_FRAMES;
+        }
+
+        ~DepthPrepass()
+        {
+            glDeleteQueries(QUERY_FRAMES, prepassQueries);
+            glDeleteQueries(QUERY_FRAMES, shadingQueries);
+        }
+
+        DepthPrepass(const DepthPrepass&) = delete;
+        DepthPrepass& operator=(const DepthPrepass&) = delete;
+
+    private:
+        // Запити кількох кадрів по колу, щоб читання не чекало на GPU
+        static const int QUERY_FRAMES = 3;
+
+        struct DepthUniforms
+        {
+            Uniform<glm::mat4> model;
+            Uniform<glm::mat4> view;
+            Uniform<glm::mat4> projection;
+        };
+
+        struct QuerySlot
+        {
+            bool pending = false;
+            bool prepassMeasured = false;
+        };
+
+        DepthUniforms uniforms;
+        unsigned int prepassQueries[QUERY_FRAMES];
+        unsigned int shadingQueries[QUERY_FRAMES];
+        QuerySlot slots[QUERY_FRAMES];
+        QuerySlot slot;
+        int current = 0;
+
+        unsigned int shadedFragments = 0;
+        unsigned int overdrawSaved = 0;
+
+        // Результати найстарішого кадру, якщо GPU вже їх має (запит перезаписується в цьому кадрі)
+        void readResults()
+        {
+            QuerySlot& oldest = slots[current];
+            if (!oldest.pending)
+                return;
+            oldest.pending = false;
+
+            GLuint available = 0;
+            glGetQueryObjectuiv(shadingQueries[current], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                return;
+
+            GLuint shaded = 0;
+            glGetQueryObjectuiv(shadingQueries[current], GL_QUERY_RESULT, &shaded);
+            shadedFragments = shaded;
+            overdrawSaved = 0;
+
+            // Без глибинного проходу PBR-шейдер виконався б для кожного фрагмента,
+            // що пройшов GL_LESS у глибинному проході (той самий порядок подачі)
+            if (oldest.prepassMeasured)
+            {
+                GLuint rasterized = 0;
+                glGetQueryObjectuiv(prepassQueries[current], GL_QUERY_RESULT, &rasterized);
+                overdrawSaved = rasterized > shaded ? rasterized - shaded : 0;
+            }
+        }
+};
+
+#endif
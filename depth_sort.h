@@ -0,0 +1,132 @@
+#ifndef DEPTH_SORT_H
+#define DEPTH_SORT_H
+
+#include <cstdint>
+#include <vector>
+#include <numeric>
+#include <glm/glm.hpp>
+
+#include "mesh.h"
+#include "render_state.h"
+#include "frustum.h"
+
+// Глибина точки у просторі камери (відстань уздовж напрямку погляду)
+inline float viewSpaceDepth(const glm::mat4& view, const glm::vec3& point)
+{
+    return -(view[0][2] * point.x + view[1][2] * point.y + view[2][2] * point.z + view[3][2]);
+}
+
+// Інкрементальне сортування ззаду наперед.
+// Порядок з попереднього кадру - стартова точка для сортування вставками:
+// при плавному русі камери він майже відсортований, тож кадр коштує ~O(n)
+class DepthSorter
+{
+    public:
+        // Індекси центрів від найдальшого до найближчого
+        const std::vector<uint32_t>& sort(const std::vector<glm::vec3>& centers, const glm::mat4& view)
+        {
+            if (order.size() != centers.size())
+            {
+                order.resize(centers.size());
+                std::iota(order.begin(), order.end(), 0u);
+            }
+
+            depths.resize(order.size());
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                depths[i] = viewSpaceDepth(view, centers[order[i]]);
+            }
+
+            swaps = 0;
+            for (size_t i = 1; i < order.size(); ++i)
+            {
+                float depth = depths[i];
+                uint32_t index = order[i];
+                size_t j = i;
+
+                // Строге порівняння - рівні глибини зберігають торішній порядок (без мерехтіння)
+                while (j > 0 && depths[j - 1] < depth)
+                {
+                    depths[j] = depths[j - 1];
+                    order[j] = order[j - 1];
+                    --j;
+                    ++swaps;
+                }
+
+                depths[j] = depth;
+                order[j] = index;
+            }
+
+            return order;
+        }
+
+        const std::vector<uint32_t>& currentOrder() const
+        {
+            return order;
+        }
+
+        // Кількість зсувів за останнє сортування (0 - порядок не змінився)
+        size_t lastSwaps() const
+        {
+            return swaps;
+        }
+
+    private:
+        std::vector<uint32_t> order;
+        std::vector<float> depths;
+        size_t swaps = 0;
+};
+
+// Прозорий прохід для мешів з Material::depthSorted.
+// Меші реєструються один раз, порядок зберігається між кадрами
+class TransparentPass
+{
+    public:
+        void add(Mesh& mesh)
+        {
+            meshes.push_back(&mesh);
+        }
+
+        void clear()
+        {
+            meshes.clear();
+            centers.clear();
+        }
+
+        size_t size() const
+        {
+            return meshes.size();
+        }
+
+        void draw(RenderContext& context)
+        {
+            if (meshes.empty())
+                return;
+
+            // Центри оновлюються щокадру - об'єкти можуть рухатись
+            centers.resize(meshes.size());
+            for (size_t i = 0; i < meshes.size(); ++i)
+            {
+                centers[i] = glm::vec3(meshes[i]->modelMatrix()[3]);
+            }
+
+            const std::vector<uint32_t>& order = sorter.sort(centers, context.view);
+            context.state.stats.depthSortSwaps += static_cast<unsigned int>(sorter.lastSwaps());
+
+            // Невидимі лишаються в порядку сортування, щоб наступний кадр почав з майже готового
+            Frustum frustum = Frustum::fromCamera(context.view, context.projection);
+            for (uint32_t index : order)
+            {
+                if (!frustum.intersects(meshes[index]->worldBounds()))
+                    continue;
+                meshes[index]->draw(context);
+            }
+        }
+
+    private:
+        std::vector<Mesh*> meshes;
+        std::vector<glm::vec3> centers;
+        DepthSorter sorter;
+};
+
+#endif
@@ -0,0 +1,402 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define FRUSTUM_SIMD 1
+// AVX2-шлях компілюється завжди (атрибут target), вмикається за CPUID - збірка без -mavx2
+// лишається переносною. Інші компілятори - лише коли AVX2 увімкнено для всієї збірки
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FRUSTUM_AVX2 1
+#define FRUSTUM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#elif defined(__AVX2__)
+#define FRUSTUM_AVX2 1
+#define FRUSTUM_TARGET_AVX2
+#endif
+#endif
+
+// Обмежувальний паралелепіпед, вирівняний за осями
+struct AABB
+{
+    glm::vec3 min;
+    glm::vec3 max;
+
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 extent() const { return (max - min) * 0.5f; }
+
+    // Порожній бокс - нейтральний елемент для expand()
+    static AABB empty() { return {glm::vec3(1.0e30f), glm::vec3(-1.0e30f)}; }
+
+    void expand(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void expand(const AABB& box)
+    {
+        min = glm::min(min, box.min);
+        max = glm::max(max, box.max);
+    }
+
+    float surfaceArea() const
+    {
+        glm::vec3 d = glm::max(max - min, glm::vec3(0.0f));
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    bool overlaps(const AABB& box) const
+    {
+        return min.x <= box.max.x && max.x >= box.min.x &&
+               min.y <= box.max.y && max.y >= box.min.y &&
+               min.z <= box.max.z && max.z >= box.min.z;
+    }
+
+    // AABB трансформованого AABB (Arvo): центр переноситься, піврозміри - через |M|
+    AABB transformed(const glm::mat4& matrix) const
+    {
+        glm::vec3 c = glm::vec3(matrix * glm::vec4(center(), 1.0f));
+        glm::vec3 e = extent();
+        glm::vec3 r;
+        for (int i = 0; i < 3; ++i)
+        {
+            r[i] = std::fabs(matrix[0][i]) * e.x + std::fabs(matrix[1][i]) * e.y + std::fabs(matrix[2][i]) * e.z;
+        }
+        return {c - r, c + r};
+    }
+};
+
+// Шість площин піраміди видимості (ax + by + cz + d >= 0 - всередині)
+struct Frustum
+{
+    enum { LEFT = 0, RIGHT, BOTTOM, TOP, NEAR, FAR, PLANE_COUNT };
+
+    glm::vec4 planes[PLANE_COUNT];
+
+    // Площини з projection * view (Gribb & Hartmann), у світових координатах
+    static Frustum fromMatrix(const glm::mat4& viewProjection)
+    {
+        // Рядки матриці (glm зберігає стовпці)
+        glm::vec4 row[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            row[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        }
+
+        Frustum frustum;
+        frustum.planes[LEFT] = row[3] + row[0];
+        frustum.planes[RIGHT] = row[3] - row[0];
+        frustum.planes[BOTTOM] = row[3] + row[1];
+        frustum.planes[TOP] = row[3] - row[1];
+        frustum.planes[NEAR] = row[3] + row[2];
+        frustum.planes[FAR] = row[3] - row[2];
+
+        for (glm::vec4& plane : frustum.planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    static Frustum fromCamera(const glm::mat4& view, const glm::mat4& projection)
+    {
+        return fromMatrix(projection * view);
+    }
+
+    enum Containment { OUTSIDE = 0, INTERSECTS, INSIDE };
+
+    // Для ієрархій: бокс повністю всередині - піддерево можна не перевіряти
+    Containment classify(const AABB& box) const
+    {
+        glm::vec3 c = box.center();
+        glm::vec3 e = box.extent();
+        Containment result = INSIDE;
+        for (const glm::vec4& plane : planes)
+        {
+            float distance = plane.x * c.x + plane.y * c.y + plane.z * c.z + plane.w;
+            float radius = std::fabs(plane.x) * e.x + std::fabs(plane.y) * e.y + std::fabs(plane.z) * e.z;
+            if (distance + radius < 0.0f)
+                return OUTSIDE;
+            if (distance - radius < 0.0f)
+                result = INTERSECTS;
+        }
+        return result;
+    }
+
+    bool intersects(const AABB& box) const
+    {
+        glm::vec3 c = box.center();
+        glm::vec3 e = box.extent();
+        for (const glm::vec4& plane : planes)
+        {
+            float distance = plane.x * c.x + plane.y * c.y + plane.z * c.z + plane.w;
+            float radius = std::fabs(plane.x) * e.x + std::fabs(plane.y) * e.y + std::fabs(plane.z) * e.z;
+            if (distance + radius < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
+// Відсікання за пірамідою видимості над SoA-масивами AABB (центр / піврозмір).
+// Обʼєкти перевіряються по 8 (AVX2 + FMA, обирається під час виконання) або по 4 (SSE) за раз,
+// без розгалужень: сума "відстань + радіус" по шести площинах зводиться до мінімуму, маска
+// видимих стискається таблицею в компактний список індексів.
+// Масиви доповнюються до кратного 8 "порожніми" боксами, тож хвіст не потребує скалярного коду
+class FrustumCuller
+{
+    public:
+        static const size_t LANES = 8;
+
+        void clear()
+        {
+            forEachColumn([](std::vector<float>& column) { column.clear(); });
+            count = 0;
+        }
+
+        // Повертає індекс об'єкта (він же індекс у списку видимих)
+        uint32_t add(const AABB& box)
+        {
+            if (count % LANES == 0)
+            {
+                // Новий блок: доповнення боксами з від'ємним піврозміром - вони завжди за межами
+                size_t padded = count + LANES;
+                forEachColumn([padded](std::vector<float>& column) { column.resize(padded, 0.0f); });
+                for (size_t i = count; i < count + LANES; ++i)
+                {
+                    extentX[i] = extentY[i] = extentZ[i] = -1.0e30f;
+                }
+            }
+            set(count, box);
+            return static_cast<uint32_t>(count++);
+        }
+
+        void update(uint32_t index, const AABB& box)
+        {
+            set(index, box);
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        // Індекси видимих об'єктів у порядку додавання
+        const std::vector<uint32_t>& cull(const Frustum& frustum)
+        {
+            // Стиснення пише по 4 індекси, хвіст після останнього видимого - запас
+            visible.resize(count + LANES);
+            size_t visibleCount;
+
+#if defined(FRUSTUM_AVX2)
+            visibleCount = hasAvx2() ? cullAVX2(frustum) : cullSSE(frustum);
+#elif defined(FRUSTUM_SIMD)
+            visibleCount = cullSSE(frustum);
+#else
+            visibleCount = cullScalar(frustum);
+#endif
+
+            visible.resize(visibleCount);
+            return visible;
+        }
+
+        const std::vector<uint32_t>& visibleIndices() const
+        {
+            return visible;
+        }
+
+    private:
+        size_t count = 0;
+        std::vector<float> centerX, centerY, centerZ;
+        std::vector<float> extentX, extentY, extentZ;
+        std::vector<uint32_t> visible;
+
+        template<typename F>
+        void forEachColumn(F function)
+        {
+            std::vector<float>* columns[] = {&centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ};
+            for (std::vector<float>* column : columns)
+            {
+                function(*column);
+            }
+        }
+
+        void set(size_t index, const AABB& box)
+        {
+            glm::vec3 c = box.center();
+            glm::vec3 e = box.extent();
+            centerX[index] = c.x; centerY[index] = c.y; centerZ[index] = c.z;
+            extentX[index] = e.x; extentY[index] = e.y; extentZ[index] = e.z;
+        }
+
+        size_t cullScalar(const Frustum& frustum)
+        {
+            size_t visibleCount = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                AABB box = {glm::vec3(centerX[i], centerY[i], centerZ[i]) - glm::vec3(extentX[i], extentY[i], extentZ[i]),
+                            glm::vec3(centerX[i], centerY[i], centerZ[i]) + glm::vec3(extentX[i], extentY[i], extentZ[i])};
+                visible[visibleCount] = static_cast<uint32_t>(i);
+                visibleCount += frustum.intersects(box) ? 1 : 0;
+            }
+            return visibleCount;
+        }
+
+#ifdef FRUSTUM_SIMD
+        // Для 4-бітної маски: номери встановлених біт підряд і їхня кількість
+        struct CompressTable
+        {
+            alignas(16) uint32_t lanes[16][4];
+            uint32_t popcount[16];
+
+            constexpr CompressTable() : lanes(), popcount()
+            {
+                for (int mask = 0; mask < 16; ++mask)
+                {
+                    uint32_t n = 0;
+                    for (uint32_t lane = 0; lane < 4; ++lane)
+                    {
+                        if (mask & (1 << lane))
+                            lanes[mask][n++] = lane;
+                    }
+                    popcount[mask] = n;
+                }
+            }
+        };
+
+        static const CompressTable& compressTable()
+        {
+            static constexpr CompressTable table;
+            return table;
+        }
+
+        // Четвірка індексів base + lane для встановлених біт mask - одним записом
+        static size_t compress(uint32_t* out, size_t visibleCount, uint32_t base, int mask)
+        {
+            const CompressTable& table = compressTable();
+            __m128i lanes = _mm_load_si128(reinterpret_cast<const __m128i*>(table.lanes[mask]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + visibleCount),
+                             _mm_add_epi32(lanes, _mm_set1_epi32(static_cast<int>(base))));
+            return visibleCount + table.popcount[mask];
+        }
+
+        size_t cullSSE(const Frustum& frustum)
+        {
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            __m128 planeX[Frustum::PLANE_COUNT], planeY[Frustum::PLANE_COUNT];
+            __m128 planeZ[Frustum::PLANE_COUNT], planeW[Frustum::PLANE_COUNT];
+            __m128 absX[Frustum::PLANE_COUNT], absY[Frustum::PLANE_COUNT], absZ[Frustum::PLANE_COUNT];
+            for (int p = 0; p < Frustum::PLANE_COUNT; ++p)
+            {
+                planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+                planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+                planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+                planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+                absX[p] = _mm_andnot_ps(signMask, planeX[p]);
+                absY[p] = _mm_andnot_ps(signMask, planeY[p]);
+                absZ[p] = _mm_andnot_ps(signMask, planeZ[p]);
+            }
+
+            uint32_t* out = visible.data();
+            size_t visibleCount = 0;
+            for (size_t i = 0; i < count; i += 4)
+            {
+                __m128 cx = _mm_loadu_ps(&centerX[i]);
+                __m128 cy = _mm_loadu_ps(&centerY[i]);
+                __m128 cz = _mm_loadu_ps(&centerZ[i]);
+                __m128 ex = _mm_loadu_ps(&extentX[i]);
+                __m128 ey = _mm_loadu_ps(&extentY[i]);
+                __m128 ez = _mm_loadu_ps(&extentZ[i]);
+
+                // Найменше "відстань + радіус" по площинах: < 0 - бокс повністю за однією з них
+                __m128 nearest = _mm_set1_ps(1.0e30f);
+                for (int p = 0; p < Frustum::PLANE_COUNT; ++p)
+                {
+                    __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)),
+                                                 _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+                    __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)),
+                                               _mm_mul_ps(absZ[p], ez));
+                    nearest = _mm_min_ps(nearest, _mm_add_ps(distance, radius));
+                }
+
+                int mask = _mm_movemask_ps(_mm_cmpge_ps(nearest, _mm_setzero_ps()));
+                visibleCount = compress(out, visibleCount, static_cast<uint32_t>(i), mask);
+            }
+            return visibleCount;
+        }
+#endif
+
+#if defined(FRUSTUM_AVX2)
+        static bool hasAvx2()
+        {
+#if defined(__AVX2__) && defined(__FMA__)
+            return true;
+#else
+            static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            return supported;
+#endif
+        }
+
+        FRUSTUM_TARGET_AVX2 size_t cullAVX2(const Frustum& frustum)
+        {
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            __m256 planeX[Frustum::PLANE_COUNT], planeY[Frustum::PLANE_COUNT];
+            __m256 planeZ[Frustum::PLANE_COUNT], planeW[Frustum::PLANE_COUNT];
+            __m256 absX[Frustum::PLANE_COUNT], absY[Frustum::PLANE_COUNT], absZ[Frustum::PLANE_COUNT];
+            for (int p = 0; p < Frustum::PLANE_COUNT; ++p)
+            {
+                planeX[p] = _mm256_set1_ps(frustum.planes[p].x);
+                planeY[p] = _mm256_set1_ps(frustum.planes[p].y);
+                planeZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+                planeW[p] = _mm256_set1_ps(frustum.planes[p].w);
+                absX[p] = _mm256_andnot_ps(signMask, planeX[p]);
+                absY[p] = _mm256_andnot_ps(signMask, planeY[p]);
+                absZ[p] = _mm256_andnot_ps(signMask, planeZ[p]);
+            }
+
+            const CompressTable& table = compressTable();
+            uint32_t* out = visible.data();
+            size_t visibleCount = 0;
+            for (size_t i = 0; i < count; i += 8)
+            {
+                __m256 cx = _mm256_loadu_ps(&centerX[i]);
+                __m256 cy = _mm256_loadu_ps(&centerY[i]);
+                __m256 cz = _mm256_loadu_ps(&centerZ[i]);
+                __m256 ex = _mm256_loadu_ps(&extentX[i]);
+                __m256 ey = _mm256_loadu_ps(&extentY[i]);
+                __m256 ez = _mm256_loadu_ps(&extentZ[i]);
+
+                __m256 nearest = _mm256_set1_ps(1.0e30f);
+                for (int p = 0; p < Frustum::PLANE_COUNT; ++p)
+                {
+                    __m256 sum = _mm256_fmadd_ps(planeX[p], cx, planeW[p]);
+                    sum = _mm256_fmadd_ps(planeY[p], cy, sum);
+                    sum = _mm256_fmadd_ps(planeZ[p], cz, sum);
+                    sum = _mm256_fmadd_ps(absX[p], ex, sum);
+                    sum = _mm256_fmadd_ps(absY[p], ey, sum);
+                    sum = _mm256_fmadd_ps(absZ[p], ez, sum);
+                    nearest = _mm256_min_ps(nearest, sum);
+                }
+
+                // Дві четвірки по 4-бітній таблиці: друга пишеться одразу за видимими з першої
+                int mask = _mm256_movemask_ps(_mm256_cmp_ps(nearest, _mm256_setzero_ps(), _CMP_GE_OQ));
+                __m128i base = _mm_set1_epi32(static_cast<int>(i));
+                __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(table.lanes[mask & 15]));
+                __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(table.lanes[mask >> 4]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + visibleCount), _mm_add_epi32(low, base));
+                visibleCount += table.popcount[mask & 15];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + visibleCount),
+                                 _mm_add_epi32(high, _mm_add_epi32(base, _mm_set1_epi32(4))));
+                visibleCount += table.popcount[mask >> 4];
+            }
+            return visibleCount;
+        }
+#endif
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef INDEX_BUFFER_H
+#define INDEX_BUFFER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+
+// Найвужчий тип індексу для мешу з vertexCount вершинами
+inline GLenum indexTypeFor(size_t vertexCount)
+{
+    return vertexCount <= 0x10000 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+inline size_t indexSize(GLenum type)
+{
+    return type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+// GL_ELEMENT_ARRAY_BUFFER з автоматичним вибором GL_UNSIGNED_SHORT / GL_UNSIGNED_INT.
+// Буфер прив'язується до VAO, тому upload() викликається з уже прив'язаним VAO
+class IndexBuffer
+{
+    public:
+        GLuint ID = 0;
+        GLenum type = GL_UNSIGNED_INT;
+        GLsizei count = 0;
+
+        IndexBuffer()
+        {
+            glGenBuffers(1, &ID);
+        }
+
+        // vertexCount - кількість вершин, на які посилаються індекси (для мешів в арені -
+        // найбільша кількість вершин одного меша, зсув дає baseVertex)
+        void upload(const std::vector<unsigned int>& indices, size_t vertexCount)
+        {
+            GLsizei indexCount = static_cast<GLsizei>(indices.size());
+            if (indexTypeFor(vertexCount) == GL_UNSIGNED_SHORT)
+            {
+                std::vector<uint16_t> narrow(indices.begin(), indices.end());
+                upload(narrow.data(), indexCount, GL_UNSIGNED_SHORT);
+            }
+            else
+            {
+                upload(indices.data(), indexCount, GL_UNSIGNED_INT);
+            }
+        }
+
+        // Індекси вже в потрібному типі (наприклад, прямо з відображеного в пам'ять кешу моделі)
+        void upload(const void* data, GLsizei indexCount, GLenum indexType)
+        {
+            type = indexType;
+            count = indexCount;
+
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, bytes(), data, GL_STATIC_DRAW);
+        }
+
+        // Зсув першого індексу в байтах (аргумент indices у glDrawElements*)
+        void* offset(size_t firstIndex) const
+        {
+            return (void*)(firstIndex * indexSize(type));
+        }
+
+        size_t bytes() const
+        {
+            return count * indexSize(type);
+        }
+
+        ~IndexBuffer()
+        {
+            glDeleteBuffers(1, &ID);
+        }
+
+        IndexBuffer(const IndexBuffer&) = delete;
+        IndexBuffer& operator=(const IndexBuffer&) = delete;
+};
+
+#endif
@@ -0,0 +1,411 @@
+#ifndef INDIRECT_RENDERER_H
+#define INDIRECT_RENDERER_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "texture.h"
+#include "material.h"
+#include "mesh.h"
+#include "render_state.h"
+#include "depth_sort.h"
+#include "normal_matrix.h"
+
+// Точка прив'язки SSBO з даними викликів (layout(binding = 2) у vertex_shader_indirect.vs)
+const GLuint DRAW_DATA_BINDING = 2;
+
+// Формат запису для glMultiDrawElementsIndirect (визначений специфікацією)
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// Дані одного виклику (std430), шейдер читає їх за gl_BaseInstance
+struct GpuDrawData
+{
+    glm::mat4 model;
+    GpuNormalMatrix normal;
+    unsigned int materialIndex;
+    unsigned int pad0;
+    unsigned int pad1;
+    unsigned int pad2;
+};
+
+static_assert(sizeof(GpuDrawData) == 128, "GpuDrawData must match the std430 layout of struct DrawData");
+
+// Спільний буфер вершин та індексів для всієї статичної геометрії
+class GeometryArena
+{
+    public:
+        // Положення меша в арені (поля DrawElementsIndirectCommand)
+        struct Range
+        {
+            GLuint firstIndex;
+            GLuint indexCount;
+            GLint baseVertex;
+        };
+
+        unsigned int VAO, VBO;
+        IndexBuffer indexBuffer;
+
+        GeometryArena()
+        {
+            glGenVertexArrays(1, &VAO);
+            glGenBuffers(1, &VBO);
+        }
+
+        // Індекси меша лишаються локальними - зсув задає baseVertex, тому тип індексу
+        // визначає найбільший меш, а не вся арена
+        Range add(const MeshGeometry& geometry)
+        {
+            maxMeshVertices = std::max(maxMeshVertices, geometry.vertices.size());
+
+            Range range;
+            range.firstIndex = static_cast<GLuint>(indices.size());
+            range.indexCount = static_cast<GLuint>(geometry.indices.size());
+            range.baseVertex = static_cast<GLint>(vertices.size());
+
+            vertices.insert(vertices.end(), geometry.vertices.begin(), geometry.vertices.end());
+            indices.insert(indices.end(), geometry.indices.begin(), geometry.indices.end());
+            return range;
+        }
+
+        // Вершини пакуються в CubeLayout - ту саму розкладку, що й у Cube та CubeBatch
+        void upload()
+        {
+            std::vector<unsigned char> packed = CubeLayout::pack(vertices);
+
+            glBindVertexArray(VAO);
+
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+
+            indexBuffer.upload(indices, maxMeshVertices);
+
+            CubeLayout::setup();
+
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            std::cout << "GEOMETRY_ARENA::UPLOADED " << vertices.size() << " vertices x "
+                      << CubeLayout::stride << " bytes, " << indices.size() << " indices x "
+                      << indexSize(indexBuffer.type) << " bytes" << std::endl;
+        }
+
+        ~GeometryArena()
+        {
+            glDeleteVertexArrays(1, &VAO);
+            glDeleteBuffers(1, &VBO);
+        }
+
+        GeometryArena(const GeometryArena&) = delete;
+        GeometryArena& operator=(const GeometryArena&) = delete;
+
+    private:
+        std::vector<CubeVertex> vertices;
+        std::vector<unsigned int> indices;
+        size_t maxMeshVertices = 0;
+};
+
+// Дескриптори uniform-змінних рендерера
+struct IndirectUniforms
+{
+    Uniform<glm::vec3> viewPos;
+    Uniform<glm::mat4> view;
+    Uniform<glm::mat4> projection;
+    Uniform<bool> useTextures;
+    std::vector<Uniform<int>> textureSamplers;
+
+    IndirectUniforms() = default;
+
+    IndirectUniforms(const Shader& shader, size_t textureCount)
+    : viewPos(shader.uniform<glm::vec3>("viewPos")),
+      view(shader.uniform<glm::mat4>("view")),
+      projection(shader.uniform<glm::mat4>("projection")),
+      useTextures(shader.uniform<bool>("useTextures"))
+    {
+        for (size_t i = 0; i < textureCount; ++i)
+        {
+            textureSamplers.push_back(shader.uniform<int>("texture" + std::to_string(i)));
+        }
+    }
+};
+
+// Рендерер статичних мешів через glMultiDrawElementsIndirect.
+// Уся геометрія лежить в одній арені, кожен меш - одна команда, модельна матриця
+// та матеріал - у SSBO за gl_BaseInstance. Один виклик на прохід незалежно від кількості об'єктів
+class IndirectRenderer
+{
+    public:
+        unsigned int indirectBuffer, drawDataBuffer;
+        Shader& shader;
+        std::vector<Texture*> textures;
+        // Шейдер з TEXTURE_ARRAY: шар береться з матеріалу виклику, textures порожній
+        TextureArray* textureArray = nullptr;
+        bool showTex;
+
+        // false - Material::depthSorted ігнорується. Встановлювати до add()
+        bool depthSorting = true;
+
+        IndirectRenderer(Shader& shaderRef, MaterialBuffer& materialTable,
+                         const std::vector<Texture*>& texs, bool showTex = true)
+        : shader(shaderRef), textures(texs), showTex(showTex), materials(materialTable)
+        {
+            uniforms = IndirectUniforms(shader, textures.size());
+            inputValid = validateVertexInput<CubeLayout>(shader, "INDIRECT_RENDERER");
+            glGenBuffers(1, &indirectBuffer);
+            glGenBuffers(1, &drawDataBuffer);
+        }
+
+        // Додати меш до проходу, визначеного його матеріалом. Викликати до build()
+        void add(const Mesh& mesh)
+        {
+            MeshGeometry geometry = mesh.geometry();
+            if (geometry.indices.empty())
+            {
+                std::cout << "ERROR::INDIRECT_RENDERER::MESH_HAS_NO_GEOMETRY" << std::endl;
+                return;
+            }
+
+            Material material = mesh.meshMaterial();
+
+            PendingDraw draw;
+            draw.range = arena.add(geometry);
+            draw.model = mesh.modelMatrix();
+            draw.materialIndex = materials.add(material);
+            draw.pass = renderPassFor(material);
+            draw.depthSorted = depthSorting && draw.pass == RenderPass::TRANSPARENT && material.depthSorted;
+            pending.push_back(draw);
+        }
+
+        // Завантаження арени, команд і даних викликів. Команди групуються за проходом;
+        // у прозорому проході команди з depthSorted лежать наприкінці, щоб сортувати лише їх
+        void build()
+        {
+            arena.upload();
+            materials.upload();
+
+            std::vector<DrawElementsIndirectCommand> commands;
+            std::vector<GpuDrawData> drawData;
+            sortedCommands.clear();
+            sortedCenters.clear();
+
+            // Порядок команд: за проходом, у межах проходу - спершу без depthSorted
+            std::vector<const PendingDraw*> ordered;
+            for (const PendingDraw& draw : pending)
+            {
+                ordered.push_back(&draw);
+            }
+            std::stable_sort(ordered.begin(), ordered.end(), [](const PendingDraw* a, const PendingDraw* b) {
+                if (a->pass != b->pass)
+                    return a->pass < b->pass;
+                return a->depthSorted < b->depthSorted;
+            });
+
+            for (int pass = 0; pass < PASS_COUNT; ++pass)
+            {
+                passFirst[pass] = 0;
+                passCount[pass] = 0;
+            }
+
+            for (const PendingDraw* draw : ordered)
+            {
+                int pass = static_cast<int>(draw->pass);
+                if (passCount[pass] == 0)
+                    passFirst[pass] = commands.size();
+                passCount[pass]++;
+
+                DrawElementsIndirectCommand command;
+                command.count = draw->range.indexCount;
+                command.instanceCount = 1;
+                command.firstIndex = draw->range.firstIndex;
+                command.baseVertex = draw->range.baseVertex;
+                command.baseInstance = static_cast<GLuint>(drawData.size());
+
+                if (draw->depthSorted)
+                {
+                    if (sortedCommands.empty())
+                        sortedFirst = commands.size();
+                    sortedCommands.push_back(command);
+                    sortedCenters.push_back(glm::vec3(draw->model[3]));
+                }
+
+                commands.push_back(command);
+
+                GpuDrawData data;
+                data.model = draw->model;
+                data.materialIndex = draw->materialIndex;
+                data.pad0 = data.pad1 = data.pad2 = 0;
+                drawData.push_back(data);
+            }
+
+            // Матриці нормалей - одним пакетним проходом по всіх трансформаціях
+            models.resize(drawData.size());
+            normals.resize(drawData.size());
+            for (size_t i = 0; i < drawData.size(); ++i)
+            {
+                models[i] = drawData[i].model;
+            }
+            computeNormalMatrices(models.data(), models.size(), normals.data());
+            for (size_t i = 0; i < drawData.size(); ++i)
+            {
+                drawData[i].normal = normals[i];
+            }
+
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand),
+                         commands.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawDataBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, drawData.size() * sizeof(GpuDrawData),
+                         drawData.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+            std::cout << "INDIRECT_RENDERER::BUILT " << commands.size() << " draws" << std::endl;
+        }
+
+        // Програма для проходу з іншим варіантом шейдера (RenderContext::variant).
+        // Входи вершин мають читатись з арени (CubeLayout), як і в основної програми
+        void setVariant(ShaderVariant variantId, Shader& variantShader)
+        {
+            variants[static_cast<int>(variantId)] = {&variantShader, IndirectUniforms(variantShader, textures.size()),
+                                                     validateVertexInput<CubeLayout>(variantShader, "INDIRECT_RENDERER")};
+        }
+
+        // Один glMultiDrawElementsIndirect на весь прохід.
+        // Таблиця матеріалів має бути прив'язана до MATERIAL_BUFFER_BINDING
+        void draw(RenderPass pass, RenderContext& context)
+        {
+            int passIndex = static_cast<int>(pass);
+            ProgramVariant& variant = variants[static_cast<int>(context.variant)];
+            // Програма не читає CubeLayout - помилка вже в журналі
+            if (passCount[passIndex] == 0 || !(variant.shader ? variant.inputValid : inputValid))
+                return;
+
+            GLStateCache& state = context.state;
+            Shader& program = variant.shader ? *variant.shader : shader;
+            IndirectUniforms& programUniforms = variant.shader ? variant.uniforms : uniforms;
+
+            state.useProgram(program.ID);
+
+            if (state.firstUseThisFrame(program.ID))
+            {
+                programUniforms.viewPos.set(context.viewPos);
+                programUniforms.view.set(context.view);
+                programUniforms.projection.set(context.projection);
+
+                for (unsigned int i = 0; i < programUniforms.textureSamplers.size(); i++)
+                {
+                    programUniforms.textureSamplers[i].set(static_cast<int>(i));
+                }
+            }
+
+            bool hasTextures = !textures.empty() || textureArray;
+            programUniforms.useTextures.set(hasTextures && showTex);
+
+            if (textureArray)
+            {
+                state.bindTexture(TEXTURE_ARRAY_UNIT, textureArray->ID, GL_TEXTURE_2D_ARRAY, textureArray->sampler);
+            }
+            for (unsigned int i = 0; i < textures.size(); i++)
+            {
+                state.bindTexture(i, textures[i]->ID, GL_TEXTURE_2D, textures[i]->sampler);
+            }
+
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, drawDataBuffer);
+            state.bindVertexArray(arena.VAO);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+
+            // OIT не залежить від порядку команд
+            if (pass == RenderPass::TRANSPARENT && !sortedCommands.empty() && context.variant != ShaderVariant::OIT)
+            {
+                sortCommands(context);
+            }
+
+            glMultiDrawElementsIndirect(GL_TRIANGLES, arena.indexBuffer.type,
+                                        (void*)(passFirst[passIndex] * sizeof(DrawElementsIndirectCommand)),
+                                        static_cast<GLsizei>(passCount[passIndex]), 0);
+            state.stats.drawCalls++;
+
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+
+        ~IndirectRenderer()
+        {
+            glDeleteBuffers(1, &indirectBuffer);
+            glDeleteBuffers(1, &drawDataBuffer);
+        }
+
+        IndirectRenderer(const IndirectRenderer&) = delete;
+        IndirectRenderer& operator=(const IndirectRenderer&) = delete;
+
+    private:
+        static const int PASS_COUNT = 2;
+
+        struct PendingDraw
+        {
+            GeometryArena::Range range;
+            glm::mat4 model;
+            unsigned int materialIndex;
+            RenderPass pass;
+            bool depthSorted;
+        };
+
+        MaterialBuffer& materials;
+        GeometryArena arena;
+        IndirectUniforms uniforms;
+        struct ProgramVariant
+        {
+            Shader* shader = nullptr;
+            IndirectUniforms uniforms;
+            bool inputValid = false;
+        };
+        ProgramVariant variants[SHADER_VARIANT_COUNT];
+        bool inputValid = false;
+        std::vector<PendingDraw> pending;
+        std::vector<glm::mat4> models;
+        std::vector<GpuNormalMatrix> normals;
+        size_t passFirst[PASS_COUNT] = {0, 0};
+        size_t passCount[PASS_COUNT] = {0, 0};
+
+        // Прозорі команди з depthSorted: CPU-копія в порядку build() та центри об'єктів
+        size_t sortedFirst = 0;
+        std::vector<DrawElementsIndirectCommand> sortedCommands;
+        std::vector<glm::vec3> sortedCenters;
+        std::vector<DrawElementsIndirectCommand> sortedStaging;
+        DepthSorter sorter;
+        bool sortedUploaded = false;
+
+        // Переставляє команди ззаду наперед; буфер оновлюється лише при зміні порядку.
+        // baseInstance лишається в команді, тож дані викликів не переставляються
+        void sortCommands(RenderContext& context)
+        {
+            const std::vector<uint32_t>& order = sorter.sort(sortedCenters, context.view);
+            context.state.stats.depthSortSwaps += static_cast<unsigned int>(sorter.lastSwaps());
+
+            if (sorter.lastSwaps() == 0 && sortedUploaded)
+                return;
+
+            sortedStaging.resize(order.size());
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                sortedStaging[i] = sortedCommands[order[i]];
+            }
+
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, sortedFirst * sizeof(DrawElementsIndirectCommand),
+                            sortedStaging.size() * sizeof(DrawElementsIndirectCommand), sortedStaging.data());
+            sortedUploaded = true;
+        }
+};
+
+#endif
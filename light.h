@@ -1,9 +1,15 @@
 #ifndef LIGHT_H
 #define LIGHT_H
 
+#include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cmath>
 #include <iostream>
-#include "shader.h"
+#include <vector>
+#include <algorithm>
+
+// Точка прив'язки SSBO зі світлом (layout(binding = 0) у шейдерах)
+const GLuint LIGHT_BUFFER_BINDING = 0;
 
 enum class LightType {
     DIRECTIONAL = 0,  // Напрямлене (сонце)
@@ -34,30 +40,137 @@ struct Light{
     float cutOff;        // Внутрішній кут (в радіанах)
     float outerCutOff;   // Зовнішній кут (в радіанах)
 
-    void setShaderUniforms(Shader& shader, const std::string& name, int index) const {
-        std::string uniformName = name + "[" + std::to_string(index) + "]";
-        
-        shader.setInt(uniformName + ".type", static_cast<int>(type));
-        shader.setVec3(uniformName + ".ambient", ambient);
-        shader.setVec3(uniformName + ".diffuse", diffuse);
-        shader.setVec3(uniformName + ".specular", specular);
-
-        if (type == LightType::POINT || type == LightType::SPOT) {
-            shader.setVec3(uniformName + ".position", position);
-            shader.setFloat(uniformName + ".constant", constant);
-            shader.setFloat(uniformName + ".linear", linear);
-            shader.setFloat(uniformName + ".quadratic", quadratic);
+    // Відстань, за якою внесок світла менший за threshold (частка від 1.0 яскравості):
+    // корінь constant + linear * d + quadratic * d^2 = max(diffuse) / threshold.
+    // Для напрямленого світла межі немає (-1)
+    float effectiveRadius(float threshold = 1.0f / 256.0f) const
+    {
+        if (type == LightType::DIRECTIONAL)
+            return -1.0f;
+
+        float intensity = std::max(diffuse.x, std::max(diffuse.y, diffuse.z));
+        float c = constant - intensity / threshold;
+        if (c >= 0.0f)
+            return 0.0f;
+
+        if (quadratic > 0.0f)
+            return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+        if (linear > 0.0f)
+            return -c / linear;
+
+        // Без затухання світло дістає всюди
+        return 1.0e30f;
+    }
+};
+
+// Представлення Light у GPU-буфері (std430), дзеркалить struct Light у шейдерах.
+// Скаляри заповнюють четверту компоненту попереднього vec3
+struct GpuLight
+{
+    glm::vec3 position;
+    int type;
+    glm::vec3 direction;
+    float constant;
+    glm::vec3 ambient;
+    float linear;
+    glm::vec3 diffuse;
+    float quadratic;
+    glm::vec3 specular;
+    float cutOff;
+    float outerCutOff;
+    float radius;        // Light::effectiveRadius(), -1 для напрямленого
+    float pad1;
+    float pad2;
+
+    explicit GpuLight(const Light& light)
+    : position(light.position), type(static_cast<int>(light.type)),
+      direction(light.direction), constant(light.constant),
+      ambient(light.ambient), linear(light.linear),
+      diffuse(light.diffuse), quadratic(light.quadratic),
+      specular(light.specular), cutOff(light.cutOff),
+      outerCutOff(light.outerCutOff), radius(light.effectiveRadius()), pad1(0.0f), pad2(0.0f)
+    {}
+};
+
+static_assert(sizeof(GpuLight) == 96, "GpuLight must match the std430 layout of struct Light");
+
+// Заголовок буфера: кількість джерел і сумарний ambient (він не затухає, тож не залежить
+// від кластера); масив lights[] починається з 32 байт
+struct GpuLightHeader
+{
+    int count;
+    int pad0[3];
+    glm::vec3 ambient;
+    float pad1;
+};
+
+static_assert(sizeof(GpuLightHeader) == 32, "GpuLightHeader must match the std430 layout of LightBlock");
+
+// SSBO зі всіма джерелами світла сцени.
+// Оновлюється один раз за кадр і прив'язується один раз для всіх викликів малювання
+class LightBuffer
+{
+    public:
+        unsigned int ID = 0;
+
+        explicit LightBuffer(size_t initialCapacity = 16)
+        {
+            glGenBuffers(1, &ID);
+            reserve(initialCapacity);
         }
 
-        if (type == LightType::DIRECTIONAL || type == LightType::SPOT) {
-            shader.setVec3(uniformName + ".direction", direction);
+        // Прив'язка до LIGHT_BUFFER_BINDING (достатньо одного разу - перевиділення пам'яті не змінює ID)
+        void bind() const
+        {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BUFFER_BINDING, ID);
         }
 
-        if (type == LightType::SPOT) {
-            shader.setFloat(uniformName + ".cutOff", cutOff);
-            shader.setFloat(uniformName + ".outerCutOff", outerCutOff);
+        void upload(const std::vector<Light>& lights)
+        {
+            if (lights.size() > capacity) {
+                reserve(std::max(lights.size(), capacity * 2));
+            }
+
+            GpuLightHeader header = {static_cast<int>(lights.size()), {0, 0, 0}, glm::vec3(0.0f), 0.0f};
+
+            staging.clear();
+            for (const Light& light : lights) {
+                staging.emplace_back(light);
+                header.ambient += light.ambient;
+            }
+
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GpuLightHeader), &header);
+            if (!staging.empty()) {
+                glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(GpuLightHeader),
+                                staging.size() * sizeof(GpuLight), staging.data());
+            }
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        }
+
+        ~LightBuffer()
+        {
+            if (ID != 0) {
+                glDeleteBuffers(1, &ID);
+                ID = 0;
+            }
+        }
+
+        LightBuffer(const LightBuffer&) = delete;
+        LightBuffer& operator=(const LightBuffer&) = delete;
+
+    private:
+        size_t capacity = 0;
+        std::vector<GpuLight> staging;
+
+        void reserve(size_t count)
+        {
+            capacity = count;
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GpuLightHeader) + capacity * sizeof(GpuLight),
+                         nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
         }
-    }
 };
 
 namespace Lights {
@@ -0,0 +1,296 @@
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "light.h"
+#include "frustum.h"
+
+// Точки прив'язки SSBO кластерів (layout(binding = 3/4) у fragment_shader_1.fs)
+const GLuint CLUSTER_GRID_BINDING = 3;
+const GLuint CLUSTER_INDEX_BINDING = 4;
+
+// Заголовок ClusterGrid (std430), за ним - масив uvec2 (зсув, кількість) на кластер
+struct GpuClusterHeader
+{
+    glm::uvec4 gridSize;      // x, y, z; w - 1, якщо кластери увімкнені
+    glm::uvec4 globalLights;  // x - кількість джерел без радіусу на початку списку індексів
+    glm::vec4 depthParams;    // scale, bias для зрізу log(z); near, far
+    glm::vec4 tileSize;       // розмір тайла в пікселях (xy)
+};
+
+static_assert(sizeof(GpuClusterHeader) == 64, "GpuClusterHeader must match the std430 layout of ClusterGrid");
+
+// Clustered forward: піраміда видимості ділиться на сітку 16x9x24 (зрізи за глибиною
+// експоненційні), кожне точкове світло та прожектор потрапляє лише в кластери, які перетинає
+// його сфера дії (Light::effectiveRadius). Фрагмент перебирає тільки список свого кластера.
+// Розподіл виконується на CPU раз на кадр
+class LightClusters
+{
+    public:
+        static const unsigned int GRID_X = 16;
+        static const unsigned int GRID_Y = 9;
+        static const unsigned int GRID_Z = 24;
+        static const unsigned int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+        unsigned int gridBuffer = 0, indexBuffer = 0;
+
+        // false - шейдер перебирає всі джерела (для порівняння)
+        bool enabled = true;
+
+        LightClusters()
+        {
+            glGenBuffers(1, &gridBuffer);
+            glGenBuffers(1, &indexBuffer);
+
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, gridBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GpuClusterHeader) + CLUSTER_COUNT * sizeof(glm::uvec2),
+                         nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+            reserveIndices(1024);
+        }
+
+        // Прив'язка один раз - перевиділення пам'яті не змінює ID
+        void bind() const
+        {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_GRID_BINDING, gridBuffer);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_INDEX_BINDING, indexBuffer);
+        }
+
+        // Індекси в lights збігаються з індексами в LightBuffer
+        void update(const std::vector<Light>& lights, const glm::mat4& view, const glm::mat4& projection,
+                    float nearPlane, float farPlane, int width, int height)
+        {
+            if (projection != cachedProjection || nearPlane != zNear || farPlane != zFar)
+            {
+                cachedProjection = projection;
+                zNear = nearPlane;
+                zFar = farPlane;
+                buildClusterBounds();
+            }
+
+            GpuClusterHeader header;
+            header.gridSize = glm::uvec4(GRID_X, GRID_Y, GRID_Z, enabled ? 1u : 0u);
+            header.depthParams = glm::vec4(depthScale(), depthBias(), zNear, zFar);
+            header.tileSize = glm::vec4(float(width) / GRID_X, float(height) / GRID_Y, 0.0f, 0.0f);
+
+            globalIndices.clear();
+            pairs.clear();
+            if (enabled)
+            {
+                for (uint32_t i = 0; i < lights.size(); ++i)
+                {
+                    float radius = lights[i].effectiveRadius();
+                    if (radius < 0.0f)
+                        globalIndices.push_back(i);
+                    else if (radius > 0.0f)
+                        assignLight(i, glm::vec3(view * glm::vec4(lights[i].position, 1.0f)), radius);
+                }
+            }
+            header.globalLights = glm::uvec4(static_cast<unsigned int>(globalIndices.size()), 0u, 0u, 0u);
+
+            // Сортування підрахунком за кластером: спершу глобальні, далі списки кластерів підряд
+            std::fill(cells.begin(), cells.end(), glm::uvec2(0u));
+            for (const LightPair& pair : pairs)
+            {
+                cells[pair.cluster].y++;
+            }
+            uint32_t offset = static_cast<uint32_t>(globalIndices.size());
+            for (glm::uvec2& cell : cells)
+            {
+                cell.x = offset;
+                offset += cell.y;
+                cell.y = 0;
+            }
+
+            indices.resize(offset);
+            std::copy(globalIndices.begin(), globalIndices.end(), indices.begin());
+            for (const LightPair& pair : pairs)
+            {
+                glm::uvec2& cell = cells[pair.cluster];
+                indices[cell.x + cell.y++] = pair.light;
+            }
+
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, gridBuffer);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GpuClusterHeader), &header);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(GpuClusterHeader),
+                            cells.size() * sizeof(glm::uvec2), cells.data());
+
+            if (indices.size() > indexCapacity)
+            {
+                reserveIndices(std::max(indices.size(), indexCapacity * 2));
+            }
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+            if (!indices.empty())
+            {
+                glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, indices.size() * sizeof(uint32_t), indices.data());
+            }
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        }
+
+        // Сумарна кількість пар (кластер, світло) за останній кадр
+        size_t assignmentCount() const
+        {
+            return pairs.size();
+        }
+
+        ~LightClusters()
+        {
+            glDeleteBuffers(1, &gridBuffer);
+            glDeleteBuffers(1, &indexBuffer);
+        }
+
+        LightClusters(const LightClusters&) = delete;
+        LightClusters& operator=(const LightClusters&) = delete;
+
+    private:
+        struct LightPair
+        {
+            uint32_t cluster;
+            uint32_t light;
+        };
+
+        glm::mat4 cachedProjection = glm::mat4(0.0f);
+        float zNear = 0.0f;
+        float zFar = 0.0f;
+        size_t indexCapacity = 0;
+
+        std::vector<AABB> clusterBounds = std::vector<AABB>(CLUSTER_COUNT);
+        std::vector<glm::uvec2> cells = std::vector<glm::uvec2>(CLUSTER_COUNT);
+        std::vector<LightPair> pairs;
+        std::vector<uint32_t> globalIndices;
+        std::vector<uint32_t> indices;
+
+        // slice = floor(log(z) * scale + bias), z - відстань уздовж погляду
+        float depthScale() const
+        {
+            return GRID_Z / std::log(zFar / zNear);
+        }
+
+        float depthBias() const
+        {
+            return -(GRID_Z * std::log(zNear)) / std::log(zFar / zNear);
+        }
+
+        float sliceDepth(unsigned int slice) const
+        {
+            return zNear * std::pow(zFar / zNear, float(slice) / GRID_Z);
+        }
+
+        unsigned int sliceFor(float depth) const
+        {
+            float slice = std::floor(std::log(depth) * depthScale() + depthBias());
+            return static_cast<unsigned int>(glm::clamp(slice, 0.0f, float(GRID_Z - 1)));
+        }
+
+        // AABB кластерів у просторі камери (симетрична перспектива: x = ndc * z / P[0][0])
+        void buildClusterBounds()
+        {
+            for (unsigned int z = 0; z < GRID_Z; ++z)
+            {
+                float nearDepth = sliceDepth(z);
+                float farDepth = sliceDepth(z + 1);
+
+                for (unsigned int y = 0; y < GRID_Y; ++y)
+                {
+                    for (unsigned int x = 0; x < GRID_X; ++x)
+                    {
+                        glm::vec2 ndcMin(-1.0f + 2.0f * x / GRID_X, -1.0f + 2.0f * y / GRID_Y);
+                        glm::vec2 ndcMax(-1.0f + 2.0f * (x + 1) / GRID_X, -1.0f + 2.0f * (y + 1) / GRID_Y);
+
+                        AABB bounds = AABB::empty();
+                        for (float depth : {nearDepth, farDepth})
+                        {
+                            glm::vec2 scale(depth / cachedProjection[0][0], depth / cachedProjection[1][1]);
+                            bounds.expand(glm::vec3(ndcMin * scale, -depth));
+                            bounds.expand(glm::vec3(ndcMax * scale, -depth));
+                        }
+                        clusterBounds[clusterIndex(x, y, z)] = bounds;
+                    }
+                }
+            }
+        }
+
+        static unsigned int clusterIndex(unsigned int x, unsigned int y, unsigned int z)
+        {
+            return x + GRID_X * (y + GRID_Y * z);
+        }
+
+        // Діапазон тайлів з консервативної проєкції сфери, далі - точний тест сфера/AABB кластера
+        void assignLight(uint32_t light, const glm::vec3& center, float radius)
+        {
+            float depth = -center.z;
+            float minDepth = depth - radius;
+            float maxDepth = depth + radius;
+            if (maxDepth < zNear || minDepth > zFar)
+                return;
+
+            unsigned int zFirst = sliceFor(std::max(minDepth, zNear));
+            unsigned int zLast = sliceFor(std::min(maxDepth, zFar));
+
+            unsigned int xFirst = 0, xLast = GRID_X - 1;
+            unsigned int yFirst = 0, yLast = GRID_Y - 1;
+            if (minDepth > zNear)
+            {
+                glm::vec2 ndcMin(1.0e30f), ndcMax(-1.0e30f);
+                for (float d : {minDepth, maxDepth})
+                {
+                    for (float sx : {-radius, radius})
+                    {
+                        for (float sy : {-radius, radius})
+                        {
+                            glm::vec2 ndc((center.x + sx) * cachedProjection[0][0] / d,
+                                          (center.y + sy) * cachedProjection[1][1] / d);
+                            ndcMin = glm::min(ndcMin, ndc);
+                            ndcMax = glm::max(ndcMax, ndc);
+                        }
+                    }
+                }
+                if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+                    return;
+
+                xFirst = tileFor(ndcMin.x, GRID_X);
+                xLast = tileFor(ndcMax.x, GRID_X);
+                yFirst = tileFor(ndcMin.y, GRID_Y);
+                yLast = tileFor(ndcMax.y, GRID_Y);
+            }
+
+            float radiusSquared = radius * radius;
+            for (unsigned int z = zFirst; z <= zLast; ++z)
+            {
+                for (unsigned int y = yFirst; y <= yLast; ++y)
+                {
+                    for (unsigned int x = xFirst; x <= xLast; ++x)
+                    {
+                        unsigned int cluster = clusterIndex(x, y, z);
+                        const AABB& bounds = clusterBounds[cluster];
+                        glm::vec3 d = glm::clamp(center, bounds.min, bounds.max) - center;
+                        if (glm::dot(d, d) <= radiusSquared)
+                            pairs.push_back({cluster, light});
+                    }
+                }
+            }
+        }
+
+        static unsigned int tileFor(float ndc, unsigned int tiles)
+        {
+            float tile = std::floor((ndc * 0.5f + 0.5f) * tiles);
+            return static_cast<unsigned int>(glm::clamp(tile, 0.0f, float(tiles - 1)));
+        }
+
+        void reserveIndices(size_t count)
+        {
+            indexCapacity = count;
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, indexCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        }
+};
+
+#endif
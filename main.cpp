@@ -4,6 +4,7 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <fstream>
 #include <vector>
 #include <cmath>
 #include <glm/glm.hpp>
@@ -12,10 +13,26 @@
 
 #include "shader.h"
 #include "texture.h"
+#include "sampler.h"
+#include "texture_loader.h"
+#include "texture_cache.h"
+#include "texture_array.h"
 #include "camera.h"
 #include "mesh.h"
+#include "cube_batch.h"
+#include "indirect_renderer.h"
+#include "render_state.h"
+#include "render_queue.h"
+#include "depth_sort.h"
+#include "oit_pass.h"
+#include "frustum.h"
+#include "bvh.h"
+#include "deferred.h"
+#include "depth_prepass.h"
 #include "material.h"
 #include "light.h"
+#include "light_clusters.h"
+#include "model.h"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window);
@@ -25,12 +42,27 @@ void mouse_roll_callback(GLFWwindow* window, double xpos, double ypos);
 // CONSTANTS
 const unsigned int SCR_WIDTH = 1920;
 const unsigned int SCR_HEIGHT = 1080;
+const float NEAR_PLANE = 0.1f;
+const float FAR_PLANE = 100.0f;
+// Час GL-потоку на завантаження декодованих текстур за кадр
+const double TEXTURE_UPLOAD_BUDGET_MS = 2.0;
+// Відеопам'ять на рівні міпмап зварених текстур і скільки з них довантажувати за кадр
+const size_t TEXTURE_STREAMING_BUDGET = size_t(256) << 20;
+const size_t TEXTURE_STREAMING_UPLOAD_BYTES = size_t(8) << 20;
 const char* vertexShaderSource1 = "./shaders/vertex/vertex_shader_1.vs";
 const char* fragShaderSource1 = "./shaders/fragment/fragment_shader_1.fs";
 const char* vertexShaderLightSource = "./shaders/vertex/vertex_shader_light.vs";
 const char* fragShaderLightSource = "./shaders/fragment/fragment_shader_light.fs";
+const char* vertexShaderInstancedSource = "./shaders/vertex/vertex_shader_instanced.vs";
+const char* vertexShaderIndirectSource = "./shaders/vertex/vertex_shader_indirect.vs";
+const char* vertexShaderDepthSource = "./shaders/vertex/vertex_shader_depth.vs";
+const char* vertexShaderFullscreenSource = "./shaders/vertex/vertex_shader_fullscreen.vs";
+const char* fragShaderOitCompositeSource = "./shaders/fragment/fragment_shader_oit_composite.fs";
+const char* fragShaderGBufferSource = "./shaders/fragment/fragment_shader_gbuffer.fs";
+const char* computeShaderDeferredSource = "./shaders/compute/compute_shader_deferred.cs";
 const char* textureSource1 = "./res/texture.jpg";
 const char* textureSource2 = "./res/awesomeface.png";
+const char* modelSource = "./res/models/model.obj";
 
 // Variables
 Camera camera(glm::vec3(0.0f, 4.0f, 15.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -5.0f);
@@ -47,11 +79,64 @@ bool tKeyPressed = false;
 bool spotlightEnabled = true;
 bool fKeyPressed = false; 
 
+// Шлях рендерингу сцени (клавіші 1-3)
+enum class RenderPath {
+    PER_OBJECT = 0,   // Cube::draw для кожного куба
+    INSTANCED = 1,    // CubeBatch, glDrawElementsInstanced
+    INDIRECT = 2      // IndirectRenderer, glMultiDrawElementsIndirect
+};
+
+RenderPath renderPath = RenderPath::PER_OBJECT;
+
+// Конвеєр освітлення непрозорих об'єктів (клавіша G)
+enum class Pipeline {
+    FORWARD = 0,      // PBR у фрагментному шейдері, шлях вибирається клавішами 1-3
+    DEFERRED = 1      // G-буфер + tiled compute shading
+};
+
+Pipeline pipeline = Pipeline::FORWARD;
+bool gKeyPressed = false;
+
+// Прозорість: сортування (depthSorted) або weighted blended OIT (клавіша O)
+enum class TransparencyMode {
+    SORTED = 0,
+    WEIGHTED_OIT = 1
+};
+
+TransparencyMode transparencyMode = TransparencyMode::SORTED;
+bool oKeyPressed = false;
+
+bool queueSorting = true;
+bool qKeyPressed = false;
+
+bool printStats = false;
+bool pKeyPressed = false;
+
+// Кластерне відсікання світла (клавіша C) і сотні додаткових точкових джерел (клавіша L)
+bool clusteredLighting = true;
+bool cKeyPressed = false;
+bool manyLights = false;
+bool lKeyPressed = false;
+
+// Глибинний прохід перед PBR-проходом непрозорих (клавіша Z, шлях по об'єктах)
+bool depthPrepassEnabled = false;
+bool zKeyPressed = false;
+
+// Відсікання кубів шляху по об'єктах: BVH або плоский FrustumCuller по всіх межах (клавіша B).
+// Лише для порівняння швидкодії - результат однаковий, час видно в статистиці (клавіша P)
+bool bvhCulling = true;
+bool bKeyPressed = false;
+
+// Вибір об'єкта променем з центру екрана (ліва кнопка миші)
+bool pickRequested = false;
+bool mouseLeftPressed = false;
+
 int main() {
     // glfw: ініціалізація та конфігурація
     glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    // 4.6: світло в SSBO (4.3+), gl_BaseInstance у шейдерах (4.6)
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
     #ifdef __APPLE__
@@ -78,7 +163,27 @@ int main() {
     }
 
     // SHADER PROGRAM
-    Shader ShadersProgram1(vertexShaderSource1, fragShaderSource1);
+    // Текстури кубів - шари TextureArray, шар задає матеріал (TEXTURE_ARRAY)
+    Shader ShadersProgram1(vertexShaderSource1, fragShaderSource1, {"TEXTURE_ARRAY"});
+    // Моделі - зі звичайними текстурами матеріалів з TextureCache
+    Shader ModelProgram(vertexShaderSource1, fragShaderSource1);
+    Shader ModelOitProgram(vertexShaderSource1, fragShaderSource1, {"OIT"});
+    // Той самий PBR-шейдер, але матеріал береться з MaterialBuffer за індексом інстансу
+    Shader InstancedProgram(vertexShaderInstancedSource, fragShaderSource1, {"MATERIAL_BUFFER", "TEXTURE_ARRAY"});
+    Shader IndirectProgram(vertexShaderIndirectSource, fragShaderSource1, {"MATERIAL_BUFFER", "TEXTURE_ARRAY"});
+    // Варіанти для OIT: прозорі пишуть у цілі accumulation / revealage
+    Shader OitProgram(vertexShaderSource1, fragShaderSource1, {"OIT", "TEXTURE_ARRAY"});
+    Shader InstancedOitProgram(vertexShaderInstancedSource, fragShaderSource1,
+                               {"MATERIAL_BUFFER", "OIT", "TEXTURE_ARRAY"});
+    Shader IndirectOitProgram(vertexShaderIndirectSource, fragShaderSource1,
+                              {"MATERIAL_BUFFER", "OIT", "TEXTURE_ARRAY"});
+    Shader OitCompositeProgram(vertexShaderFullscreenSource, fragShaderOitCompositeSource);
+    // Відкладене освітлення: запис G-буфера і освітлення по тайлах
+    Shader IndirectGBufferProgram(vertexShaderIndirectSource, fragShaderGBufferSource,
+                                  {"MATERIAL_BUFFER", "TEXTURE_ARRAY"});
+    Shader DeferredLightingProgram = Shader::compute(computeShaderDeferredSource);
+    // Глибинний прохід: лише вершинний шейдер
+    Shader DepthProgram(vertexShaderDepthSource, nullptr);
     // CUBE POSITIONS
     glm::vec3 cubePositions[] = {
         // РЯД 1: Метали (Y = 0.0f)
@@ -170,6 +275,32 @@ int main() {
         )
     };
 
+    // Додаткові слабкі точкові джерела над сценою (сітка 16x16) - навантаження для кластерів
+    std::vector<Light> extraLights;
+    for (int z = 0; z < 16; ++z) {
+        for (int x = 0; x < 16; ++x) {
+            glm::vec3 color = glm::vec3(0.5f + 0.5f * std::sin(x * 0.7f), 0.5f + 0.5f * std::sin(z * 0.9f + 2.0f),
+                                        0.5f + 0.5f * std::sin((x + z) * 0.5f + 4.0f));
+            extraLights.push_back(Lights::CreatePoint(
+                glm::vec3(-12.0f + x * 1.6f, 1.0f + (x + z) % 4 * 2.5f, -12.0f + z * 1.6f),
+                glm::vec3(0.0f),
+                color,
+                glm::vec3(0.5f),
+                1.0f,
+                0.7f,
+                1.8f
+            ));
+        }
+    }
+    std::vector<Light> frameLights;
+
+    // Буфер світла: прив'язується один раз, оновлюється раз на кадр
+    LightBuffer lightBuffer(sceneLights.size() + extraLights.size());
+    lightBuffer.bind();
+
+    LightClusters lightClusters;
+    lightClusters.bind();
+
     std::cout << "=== Джерела світла ===" << std::endl;
     std::cout << "Кількість джерел: " << sceneLights.size() << std::endl;
     for (size_t i = 0; i < sceneLights.size(); ++i) {
@@ -182,6 +313,16 @@ int main() {
     std::cout << "Колесо миші - зум" << std::endl;
     std::cout << "T - увімкнути/вимкнути текстури" << std::endl;
     std::cout << "F - увімкнути/вимкнути ліхтарик (spotlight)" << std::endl;
+    std::cout << "1/2/3 - рендеринг: по об'єктах / інстансований / multi-draw indirect" << std::endl;
+    std::cout << "Q - сортування черги малювання за станом" << std::endl;
+    std::cout << "O - прозорість: сортування / weighted blended OIT" << std::endl;
+    std::cout << "C - кластерне відсікання світла" << std::endl;
+    std::cout << "G - конвеєр: прямий / відкладений (tiled deferred)" << std::endl;
+    std::cout << "B - відсікання кубів: BVH / плоский FrustumCuller (порівняння швидкодії)" << std::endl;
+    std::cout << "Z - глибинний прохід перед освітленням непрозорих" << std::endl;
+    std::cout << "L - додати/прибрати " << extraLights.size() << " точкових джерел" << std::endl;
+    std::cout << "P - статистика GL-викликів за кадр" << std::endl;
+    std::cout << "Ліва кнопка миші - куб у центрі екрана" << std::endl;
     std::cout << "ESC - вихід\n" << std::endl;;
 
     // ============ Налаштування текстур ==============
@@ -192,9 +333,23 @@ int main() {
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
 
-    Texture texture1(textureSource1);
-    Texture texture2(textureSource2);
-    std::vector<Texture*> cubeTextures = {&texture1, &texture2};
+    // Декодування - на всіх ядрах паралельно, до завантаження в шейдері сіра заглушка.
+    // Кеш зводить повторні запити одного файлу до однієї текстури, семплери спільні для всіх
+    TextureLoader textureLoader;
+    SamplerCache samplers;
+    TextureCache textureCache(textureLoader);
+    // Рівні міпмап зварених текстур - за розміром об'єктів на екрані, в межах бюджету
+    TextureStreamer textureStreamer(TEXTURE_STREAMING_BUDGET);
+    textureCache.streamer = &textureStreamer;
+
+    // Один масив на всі куби: між об'єктами й пакетами текстури не перемикаються
+    std::shared_ptr<TextureArray> cubeTextureArray =
+        std::make_shared<TextureArray>(512, 512, 16, samplers.get(SamplerDesc::anisotropic()));
+    const int cubeLayers[] = {
+        cubeTextureArray->load(textureSource1, textureLoader),
+        cubeTextureArray->load(textureSource2, textureLoader)
+    };
+    std::vector<Texture*> cubeTextures;
 
     Material cubeMaterials[] = {
         Materials::Gold,
@@ -218,6 +373,9 @@ int main() {
         Materials::FrostedGlass,
         Materials::WhiteRubber
     };
+    for (size_t i = 0; i < std::size(cubeMaterials); i++) {
+        cubeMaterials[i].textureLayer = cubeLayers[i % std::size(cubeLayers)];
+    }
 
     std::vector<Cube> cubes;
     cubes.reserve(std::size(cubePositions));
@@ -232,8 +390,100 @@ int main() {
             cubeMaterials[i % std::size(cubeMaterials)],
             true
         );
+        cubes.back().textureArray = cubeTextureArray.get();
+
+        // Прозорі в режимі OIT малюються тим самим кубом, OIT-варіантом шейдера
+        if (renderPassFor(cubes.back().material) == RenderPass::TRANSPARENT) {
+            cubes.back().setVariant(ShaderVariant::OIT, OitProgram);
+        }
+    }
+
+    // Модель з диска (якщо є) - лише для шляху по об'єктах; перший запуск пише .meshcache
+    std::unique_ptr<Model> sceneModel;
+    if (std::ifstream(modelSource).good()) {
+        sceneModel = std::make_unique<Model>(modelSource, ModelProgram, textureCache,
+                                             samplers.get(SamplerDesc::anisotropic()),
+                                             glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -6.0f)));
+        sceneModel->setVariant(ShaderVariant::OIT, ModelOitProgram);
+    }
+
+    // Ті самі куби для інстансованого шляху: непрозорі, прозорі без порядку
+    // та прозорі з сортуванням ззаду наперед (Material::depthSorted)
+    MaterialBuffer materialBuffer;
+    CubeBatch opaqueBatch(InstancedProgram, cubeTextures);
+    CubeBatch transparentBatch(InstancedProgram, cubeTextures);
+    CubeBatch sortedTransparentBatch(InstancedProgram, cubeTextures, true, true);
+    for (CubeBatch* batch : {&opaqueBatch, &transparentBatch, &sortedTransparentBatch}) {
+        batch->textureArray = cubeTextureArray.get();
+    }
+    transparentBatch.setVariant(ShaderVariant::OIT, InstancedOitProgram);
+    sortedTransparentBatch.setVariant(ShaderVariant::OIT, InstancedOitProgram);
+
+    for (size_t i = 0; i < std::size(cubePositions); i++) {
+        const Material& material = cubeMaterials[i % std::size(cubeMaterials)];
+        unsigned int materialIndex = materialBuffer.add(material);
+        CubeBatch& batch = renderPassFor(material) == RenderPass::OPAQUE ? opaqueBatch :
+                           material.depthSorted ? sortedTransparentBatch : transparentBatch;
+        batch.add(cubePositions[i], glm::vec3(1.0f), materialIndex);
+    }
+
+    // Multi-draw indirect: уся геометрія кубів в одній арені
+    IndirectRenderer indirectRenderer(IndirectProgram, materialBuffer, cubeTextures);
+    indirectRenderer.textureArray = cubeTextureArray.get();
+    indirectRenderer.setVariant(ShaderVariant::OIT, IndirectOitProgram);
+    for (const Cube& cube : cubes) {
+        indirectRenderer.add(cube);
+    }
+    indirectRenderer.build();
+
+    // Геометричний прохід відкладеного конвеєра - лише непрозорі
+    IndirectRenderer gBufferRenderer(IndirectGBufferProgram, materialBuffer, cubeTextures);
+    gBufferRenderer.textureArray = cubeTextureArray.get();
+    for (const Cube& cube : cubes) {
+        if (renderPassFor(cube.material) == RenderPass::OPAQUE) {
+            gBufferRenderer.add(cube);
+        }
     }
+    gBufferRenderer.build();
+
+    materialBuffer.upload();
+    materialBuffer.bind();
 
+    // Черга малювання та кеш GL-стану
+    GLStateCache stateCache;
+    RenderQueue renderQueue;
+
+    // Прозорі куби, яким потрібен строгий порядок, малюються окремим проходом
+    TransparentPass transparentPass;
+    for (Cube& cube : cubes) {
+        if (renderPassFor(cube.material) == RenderPass::TRANSPARENT && cube.material.depthSorted) {
+            transparentPass.add(cube);
+        }
+    }
+
+    // BVH над межами кубів: відсікання, вибір променем і запити від джерел світла
+    // коштують пропорційно до зачепленої частини сцени
+    std::vector<AABB> cubeBounds;
+    for (const Cube& cube : cubes) {
+        cubeBounds.push_back(cube.worldBounds());
+    }
+    BVH sceneBvh;
+    sceneBvh.build(cubeBounds);
+    FrustumCuller flatCuller;
+    for (const AABB& bounds : cubeBounds) {
+        flatCuller.add(bounds);
+    }
+
+    std::vector<uint32_t> visibleCubes;
+    std::vector<ModelMesh*> visibleModelMeshes;
+
+    DepthPrepass depthPrepass(DepthProgram);
+    std::vector<Mesh*> opaqueMeshes;
+
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    WeightedBlendedOIT oit(OitCompositeProgram, framebufferWidth, framebufferHeight);
+    DeferredRenderer deferredRenderer(DeferredLightingProgram, framebufferWidth, framebufferHeight);
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetCursorPosCallback(window, mouse_callback);
@@ -248,11 +498,23 @@ int main() {
 
         processInput(window);
 
+        textureLoader.update(TEXTURE_UPLOAD_BUDGET_MS);
+        textureStreamer.update(TEXTURE_STREAMING_UPLOAD_BYTES);
+        textureCache.collect();
+
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         view = camera.GetViewMatrix();
-        projection = glm::perspective(glm::radians(camera.Fov), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+        projection = glm::perspective(glm::radians(camera.Fov), (float)SCR_WIDTH / (float)SCR_HEIGHT, NEAR_PLANE, FAR_PLANE);
+
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        oit.resize(framebufferWidth, framebufferHeight);
+        deferredRenderer.resize(framebufferWidth, framebufferHeight);
+
+        stateCache.beginFrame();
+        RenderContext context = {view, projection, camera.Position, stateCache};
+        bool useOit = transparencyMode == TransparencyMode::WEIGHTED_OIT;
 
         // Оновлюємо Spotlight (індекс 4 - останній в масиві)
         int spotlightIndex = 4;
@@ -267,21 +529,146 @@ int main() {
             sceneLights[spotlightIndex].diffuse = glm::vec3(0.0f);
             sceneLights[spotlightIndex].specular = glm::vec3(0.0f);
         }
+
+        frameLights = sceneLights;
+        if (manyLights) {
+            frameLights.insert(frameLights.end(), extraLights.begin(), extraLights.end());
+        }
+        lightBuffer.upload(frameLights);
+
+        lightClusters.enabled = clusteredLighting;
+        lightClusters.update(frameLights, view, projection, NEAR_PLANE, FAR_PLANE, framebufferWidth, framebufferHeight);
+        stateCache.stats.clusterLightPairs = static_cast<unsigned int>(lightClusters.assignmentCount());
         
-        // Малюємо непрозорі куби
-        for(size_t i = 0; i < cubes.size(); i++){
-            if(cubeMaterials[i % std::size(cubeMaterials)].alpha >= 0.99f) {
-                cubes[i].showTex = showTextures;
-                cubes[i].draw(view, projection, sceneLights, camera.Position, camera);
+        if (pipeline == Pipeline::DEFERRED) {
+            // Непрозорі - у G-буфер одним multi-draw, освітлення - раз на піксель
+            gBufferRenderer.showTex = showTextures;
+            deferredRenderer.beginGeometry();
+            gBufferRenderer.draw(RenderPass::OPAQUE, context);
+            deferredRenderer.shade(context, NEAR_PLANE, FAR_PLANE);
+
+            // Прозорі - прямим конвеєром поверх перенесеної глибини
+            indirectRenderer.showTex = showTextures;
+            if (useOit) {
+                oit.begin(context);
+                indirectRenderer.draw(RenderPass::TRANSPARENT, context);
+                oit.resolve(context);
+            } else {
+                indirectRenderer.draw(RenderPass::TRANSPARENT, context);
+            }
+        } else if (renderPath == RenderPath::INSTANCED) {
+            // Один виклик малювання на прохід
+            opaqueBatch.showTex = showTextures;
+            transparentBatch.showTex = showTextures;
+            sortedTransparentBatch.showTex = showTextures;
+            opaqueBatch.draw(context);
+            if (useOit) {
+                oit.begin(context);
+                transparentBatch.draw(context);
+                sortedTransparentBatch.draw(context);
+                oit.resolve(context);
+            } else {
+                transparentBatch.draw(context);
+                sortedTransparentBatch.draw(context);
+            }
+        } else if (renderPath == RenderPath::INDIRECT) {
+            // Один glMultiDrawElementsIndirect на прохід
+            indirectRenderer.showTex = showTextures;
+            indirectRenderer.draw(RenderPass::OPAQUE, context);
+            if (useOit) {
+                oit.begin(context);
+                indirectRenderer.draw(RenderPass::TRANSPARENT, context);
+                oit.resolve(context);
+            } else {
+                indirectRenderer.draw(RenderPass::TRANSPARENT, context);
+            }
+        } else {
+            // Ключ пакета містить прохід, тож непрозорі куби йдуть перед прозорими,
+            // а всередині проходу - згруповані за шейдером, матеріалом і текстурами
+            Frustum frustum = Frustum::fromCamera(view, projection);
+            auto cullStart = std::chrono::steady_clock::now();
+            if (bvhCulling) {
+                sceneBvh.cull(frustum, visibleCubes);
+            } else {
+                visibleCubes = flatCuller.cull(frustum);
+            }
+            stateCache.stats.cullMicroseconds += static_cast<unsigned int>(
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - cullStart).count());
+            stateCache.stats.culledObjects += cubes.size() - visibleCubes.size();
+
+            renderQueue.clear();
+            renderQueue.sortingEnabled = queueSorting;
+            for (uint32_t index : visibleCubes) {
+                Cube& cube = cubes[index];
+                cube.showTex = showTextures;
+                if (renderPassFor(cube.material) == RenderPass::TRANSPARENT && (useOit || cube.material.depthSorted))
+                    continue;
+                renderQueue.push(cube, camera.Position);
+            }
+            visibleModelMeshes.clear();
+            if (sceneModel) {
+                for (auto& mesh : sceneModel->meshes) {
+                    if (!frustum.intersects(mesh->worldBounds())) {
+                        stateCache.stats.culledObjects++;
+                        continue;
+                    }
+                    mesh->showTex = showTextures;
+                    visibleModelMeshes.push_back(mesh.get());
+                    if (!(useOit && renderPassFor(mesh->material) == RenderPass::TRANSPARENT))
+                        renderQueue.push(*mesh, camera.Position);
+
+                    float screenPixels = TextureStreamer::projectedSize(mesh->worldBounds(), camera.Position,
+                                                                        camera.Fov, framebufferHeight);
+                    for (Texture* texture : mesh->textures) {
+                        textureStreamer.request(texture, screenPixels);
+                    }
+                }
+            }
+            renderQueue.sort();
+
+            // Непрозорі: глибина спереду назад, далі PBR лише для видимих пікселів
+            renderQueue.collect(RenderPass::OPAQUE, opaqueMeshes);
+            depthPrepass.enabled = depthPrepassEnabled;
+            depthPrepass.begin(context, opaqueMeshes);
+            renderQueue.submit(context, RenderPass::OPAQUE);
+            depthPrepass.end(context);
+            renderQueue.submit(context, RenderPass::TRANSPARENT);
+
+            if (useOit) {
+                // Усі видимі прозорі - одним несортованим проходом, OIT-варіантом шейдера
+                oit.begin(context);
+                for (uint32_t index : visibleCubes) {
+                    if (renderPassFor(cubes[index].material) == RenderPass::TRANSPARENT)
+                        cubes[index].draw(context);
+                }
+                for (ModelMesh* mesh : visibleModelMeshes) {
+                    if (renderPassFor(mesh->material) == RenderPass::TRANSPARENT)
+                        mesh->draw(context);
+                }
+                oit.resolve(context);
+            } else {
+                // Прозорі з depthSorted - ззаду наперед, порядок з минулого кадру
+                transparentPass.draw(context);
             }
         }
 
-        // Малюємо прозорі куби
-        for(size_t i = 0; i < cubes.size(); i++){
-            if(cubeMaterials[i % std::size(cubeMaterials)].alpha < 0.99f) {
-                cubes[i].showTex = showTextures;
-                cubes[i].draw(view, projection, sceneLights, camera.Position, camera);
+        if (pickRequested) {
+            BVH::RayHit hit = sceneBvh.raycast(camera.Position, camera.Front);
+            if (hit.object != BVH::INVALID) {
+                glm::vec3 center = cubeBounds[hit.object].center();
+                std::cout << "Куб " << hit.object << " (" << center.x << ", " << center.y << ", " << center.z
+                          << "), відстань " << hit.distance << std::endl;
+            } else {
+                std::cout << "Промінь нічого не зачепив" << std::endl;
             }
+            pickRequested = false;
+        }
+
+        if (printStats) {
+            stateCache.stats.print(std::cout);
+            textureCache.print(std::cout);
+            textureStreamer.print(std::cout);
+            printStats = false;
         }
         
         glfwSwapBuffers(window);
@@ -289,6 +676,7 @@ int main() {
     }
 
     cubes.clear();
+    sceneModel.reset();
     cubeTextures.clear();
 
     glfwTerminate();
@@ -337,6 +725,134 @@ void processInput(GLFWwindow *window)
     {
         fKeyPressed = false;
     }
+
+    // Toggle сортування черги (клавіша Q)
+    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS && !qKeyPressed)
+    {
+        queueSorting = !queueSorting;
+        qKeyPressed = true;
+        std::cout << "Сортування черги: " << (queueSorting ? "ВКЛ" : "ВИКЛ") << std::endl;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_RELEASE)
+    {
+        qKeyPressed = false;
+    }
+
+    // Режим прозорості (клавіша O)
+    if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS && !oKeyPressed)
+    {
+        transparencyMode = transparencyMode == TransparencyMode::SORTED ?
+                           TransparencyMode::WEIGHTED_OIT : TransparencyMode::SORTED;
+        oKeyPressed = true;
+        std::cout << "Прозорість: " << (transparencyMode == TransparencyMode::SORTED ? "сортування" : "weighted blended OIT") << std::endl;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_O) == GLFW_RELEASE)
+    {
+        oKeyPressed = false;
+    }
+
+    // Прямий / відкладений конвеєр (клавіша G)
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS && !gKeyPressed)
+    {
+        pipeline = pipeline == Pipeline::FORWARD ? Pipeline::DEFERRED : Pipeline::FORWARD;
+        gKeyPressed = true;
+        std::cout << "Конвеєр: " << (pipeline == Pipeline::FORWARD ? "прямий" : "відкладений") << std::endl;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_RELEASE)
+    {
+        gKeyPressed = false;
+    }
+
+    // Кластерне відсікання світла (клавіша C)
+    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS && !cKeyPressed)
+    {
+        clusteredLighting = !clusteredLighting;
+        cKeyPressed = true;
+        std::cout << "Кластери світла: " << (clusteredLighting ? "ВКЛ" : "ВИКЛ") << std::endl;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_RELEASE)
+    {
+        cKeyPressed = false;
+    }
+
+    // Додаткові точкові джерела (клавіша L)
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS && !lKeyPressed)
+    {
+        manyLights = !manyLights;
+        lKeyPressed = true;
+        std::cout << "Додаткові джерела: " << (manyLights ? "ВКЛ" : "ВИКЛ") << std::endl;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_RELEASE)
+    {
+        lKeyPressed = false;
+    }
+
+    // Глибинний прохід (клавіша Z)
+    if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS && !zKeyPressed)
+    {
+        depthPrepassEnabled = !depthPrepassEnabled;
+        zKeyPressed = true;
+        std::cout << "Глибинний прохід: " << (depthPrepassEnabled ? "ВКЛ" : "ВИКЛ") << std::endl;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_RELEASE)
+    {
+        zKeyPressed = false;
+    }
+
+    // BVH чи плоский FrustumCuller (клавіша B)
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS && !bKeyPressed)
+    {
+        bvhCulling = !bvhCulling;
+        bKeyPressed = true;
+        std::cout << "Відсікання: " << (bvhCulling ? "BVH" : "FrustumCuller") << std::endl;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_RELEASE)
+    {
+        bKeyPressed = false;
+    }
+
+    // Статистика кадру (клавіша P)
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && !pKeyPressed)
+    {
+        printStats = true;
+        pKeyPressed = true;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE)
+    {
+        pKeyPressed = false;
+    }
+
+    // Вибір об'єкта (ліва кнопка миші)
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS && !mouseLeftPressed)
+    {
+        pickRequested = true;
+        mouseLeftPressed = true;
+    }
+
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_RELEASE)
+    {
+        mouseLeftPressed = false;
+    }
+
+    // Вибір шляху рендерингу (клавіші 1-3)
+    const int pathKeys[] = {GLFW_KEY_1, GLFW_KEY_2, GLFW_KEY_3};
+    const char* pathNames[] = {"по об'єктах", "інстансований", "multi-draw indirect"};
+    for (int i = 0; i < 3; ++i)
+    {
+        if (glfwGetKey(window, pathKeys[i]) == GLFW_PRESS && renderPath != static_cast<RenderPath>(i))
+        {
+            renderPath = static_cast<RenderPath>(i);
+            std::cout << "Рендеринг: " << pathNames[i] << std::endl;
+        }
+    }
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
@@ -0,0 +1,80 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Файл, відображений у пам'ять лише для читання. Сторінки підвантажує ОС під час
+// доступу, тож дані можна передавати прямо в glBufferData без проміжної копії
+class MappedFile
+{
+    public:
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+
+        explicit MappedFile(const std::string& path)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED)
+                {
+                    data = static_cast<const unsigned char*>(mapped);
+                    size = static_cast<size_t>(info.st_size);
+                }
+            }
+            // Відображення лишається дійсним і після закриття дескриптора
+            ::close(fd);
+        }
+
+        bool valid() const
+        {
+            return data != nullptr;
+        }
+
+        // Попросити ОС прочитати сторінки діапазону наперед (MADV_WILLNEED, не блокує):
+        // пізніший доступ не чекатиме на диск
+        void prefetch(size_t offset, size_t length) const
+        {
+            if (!data || offset >= size)
+                return;
+
+            static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            size_t begin = offset / page * page;
+            length = std::min(length, size - offset) + (offset - begin);
+            ::madvise(const_cast<unsigned char*>(data) + begin, length, MADV_WILLNEED);
+        }
+
+        ~MappedFile()
+        {
+            if (data)
+                ::munmap(const_cast<unsigned char*>(data), size);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+};
+
+// FNV-1a, 64 біти: ключ вмісту файлу для інвалідації кешів
+inline uint64_t hashBytes(const unsigned char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+#endif
@@ -1,9 +1,37 @@
 #ifndef MATERIAL_H
 #define MATERIAL_H
 
+#include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
 #include "shader.h"
 
+// Точка прив'язки SSBO з таблицею матеріалів (layout(binding = 1) у шейдерах)
+const GLuint MATERIAL_BUFFER_BINDING = 1;
+
+// Дескриптори uniform-полів структури material
+struct MaterialUniforms
+{
+    Uniform<glm::vec3> albedo;
+    Uniform<float> metallic;
+    Uniform<float> roughness;
+    Uniform<float> ao;
+    Uniform<float> alpha;
+    Uniform<int> textureLayer;
+
+    MaterialUniforms() = default;
+
+    explicit MaterialUniforms(const Shader& shader, const std::string& name = "material")
+    : albedo(shader.uniform<glm::vec3>(name + ".albedo")),
+      metallic(shader.uniform<float>(name + ".metallic")),
+      roughness(shader.uniform<float>(name + ".roughness")),
+      ao(shader.uniform<float>(name + ".ao")),
+      alpha(shader.uniform<float>(name + ".alpha")),
+      textureLayer(shader.uniform<int>(name + ".textureLayer"))
+    {}
+};
+
 struct Material
 {
     glm::vec3 albedo;      // Базовий колір
@@ -11,16 +39,133 @@ struct Material
     float roughness;       // Шорсткість (0.0 = дзеркало, 1.0 = матовий)
     float ao;              // Ambient Occlusion
     float alpha;           // Прозорість (0.0 = прозорий, 1.0 = непрозорий)
+    bool depthSorted = false;  // Прозорий прохід малює такі об'єкти строго ззаду наперед
+    int textureLayer = -1;     // Шар TextureArray (шейдери з TEXTURE_ARRAY); -1 - без текстури
 
-    void setShaderUniforms(Shader& shader) const {
-        shader.setVec3("material.albedo", albedo);
-        shader.setFloat("material.metallic", metallic);
-        shader.setFloat("material.roughness", roughness);
-        shader.setFloat("material.ao", ao);
-        shader.setFloat("material.alpha", alpha);
+    void setShaderUniforms(const MaterialUniforms& uniforms) const {
+        uniforms.albedo.set(albedo);
+        uniforms.metallic.set(metallic);
+        uniforms.roughness.set(roughness);
+        uniforms.ao.set(ao);
+        uniforms.alpha.set(alpha);
+        uniforms.textureLayer.set(textureLayer);
     }
 };
 
+inline bool sameMaterial(const Material& a, const Material& b)
+{
+    return a.albedo == b.albedo && a.metallic == b.metallic &&
+           a.roughness == b.roughness && a.ao == b.ao && a.alpha == b.alpha &&
+           a.textureLayer == b.textureLayer;
+}
+
+// Прохід рендерингу, до якого належить об'єкт
+enum class RenderPass {
+    OPAQUE = 0,
+    TRANSPARENT = 1
+};
+
+// Матеріали з alpha < 0.99 малюються після непрозорих, зі змішуванням
+inline RenderPass renderPassFor(const Material& material)
+{
+    return material.alpha >= 0.99f ? RenderPass::OPAQUE : RenderPass::TRANSPARENT;
+}
+
+// Представлення Material у GPU-таблиці (std430)
+struct GpuMaterial
+{
+    glm::vec3 albedo;
+    float metallic;
+    float roughness;
+    float ao;
+    float alpha;
+    int32_t textureLayer;
+
+    explicit GpuMaterial(const Material& material)
+    : albedo(material.albedo), metallic(material.metallic),
+      roughness(material.roughness), ao(material.ao),
+      alpha(material.alpha), textureLayer(material.textureLayer)
+    {}
+};
+
+static_assert(sizeof(GpuMaterial) == 32, "GpuMaterial must match the std430 layout of struct Material");
+
+// Таблиця матеріалів у SSBO: інстанси та пакетні виклики посилаються на матеріал за індексом
+class MaterialBuffer
+{
+    public:
+        unsigned int ID = 0;
+
+        MaterialBuffer()
+        {
+            glGenBuffers(1, &ID);
+        }
+
+        // Повертає індекс матеріалу; однакові матеріали мають спільний запис
+        unsigned int add(const Material& material)
+        {
+            for (size_t i = 0; i < materials.size(); ++i)
+            {
+                if (sameMaterial(materials[i], material))
+                    return static_cast<unsigned int>(i);
+            }
+
+            materials.push_back(material);
+            dirty = true;
+            return static_cast<unsigned int>(materials.size() - 1);
+        }
+
+        const Material& get(unsigned int index) const
+        {
+            return materials[index];
+        }
+
+        size_t size() const
+        {
+            return materials.size();
+        }
+
+        // Завантаження таблиці (лише якщо вона змінилась)
+        void upload()
+        {
+            if (!dirty)
+                return;
+
+            std::vector<GpuMaterial> staging;
+            staging.reserve(materials.size());
+            for (const Material& material : materials)
+            {
+                staging.emplace_back(material);
+            }
+
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, staging.size() * sizeof(GpuMaterial),
+                         staging.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            dirty = false;
+        }
+
+        void bind() const
+        {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_BUFFER_BINDING, ID);
+        }
+
+        ~MaterialBuffer()
+        {
+            if (ID != 0) {
+                glDeleteBuffers(1, &ID);
+                ID = 0;
+            }
+        }
+
+        MaterialBuffer(const MaterialBuffer&) = delete;
+        MaterialBuffer& operator=(const MaterialBuffer&) = delete;
+
+    private:
+        std::vector<Material> materials;
+        bool dirty = false;
+};
+
 namespace Materials {
     // МЕТАЛИ (metallic = 1.0, різна roughness)
     const Material Gold = {
@@ -46,17 +191,17 @@ namespace Materials {
     // ДІЕЛЕКТРИКИ
     const Material Emerald = {
         glm::vec3(0.07568f, 0.61424f, 0.07568f),
-        0.0f, 0.3f, 1.0f, 0.7f  // Трохи прозорий
+        0.0f, 0.3f, 1.0f, 0.7f, true  // Трохи прозорий
     };
 
     const Material Jade = {
         glm::vec3(0.54f, 0.89f, 0.63f),
-        0.0f, 0.6f, 1.0f, 0.85f  // Трохи прозорий
+        0.0f, 0.6f, 1.0f, 0.85f, true  // Трохи прозорий
     };
 
     const Material Pearl = {
         glm::vec3(1.0f, 0.829f, 0.829f),
-        0.0f, 0.5f, 1.0f, 0.9f  // Легка прозорість
+        0.0f, 0.5f, 1.0f, 0.9f, true  // Легка прозорість
     };
 
     // ПЛАСТИК
@@ -79,27 +224,27 @@ namespace Materials {
     // ПРОЗОРІ МАТЕРІАЛИ
     const Material Glass = {
         glm::vec3(0.95f, 0.95f, 0.95f),
-        0.0f, 0.05f, 1.0f, 0.3f  // Дуже прозоре
+        0.0f, 0.05f, 1.0f, 0.3f, true  // Дуже прозоре
     };
 
     const Material ColoredGlass = {
         glm::vec3(0.4f, 0.7f, 0.9f),  // Блакитне скло
-        0.0f, 0.1f, 1.0f, 0.4f
+        0.0f, 0.1f, 1.0f, 0.4f, true
     };
 
     const Material FrostedGlass = {
         glm::vec3(0.9f, 0.9f, 0.9f),
-        0.0f, 0.6f, 1.0f, 0.5f  // Матове скло
+        0.0f, 0.6f, 1.0f, 0.5f, true  // Матове скло
     };
 
     const Material Ice = {
         glm::vec3(0.85f, 0.95f, 1.0f),  // Холодний відтінок
-        0.0f, 0.15f, 1.0f, 0.6f
+        0.0f, 0.15f, 1.0f, 0.6f, true
     };
 
     const Material Water = {
         glm::vec3(0.1f, 0.3f, 0.5f),
-        0.0f, 0.1f, 1.0f, 0.5f
+        0.0f, 0.1f, 1.0f, 0.5f, true
     };
 
     // ДОДАТКОВІ МЕТАЛИ
@@ -116,12 +261,12 @@ namespace Materials {
     // НАПІВПРОЗОРІ
     const Material Amber = {
         glm::vec3(1.0f, 0.75f, 0.0f),
-        0.0f, 0.3f, 1.0f, 0.65f
+        0.0f, 0.3f, 1.0f, 0.65f, true
     };
 
     const Material Crystal = {
         glm::vec3(0.95f, 0.95f, 1.0f),
-        0.0f, 0.05f, 1.0f, 0.4f
+        0.0f, 0.05f, 1.0f, 0.4f, true
     };
 }
 
@@ -3,40 +3,176 @@
 
 #include <iostream>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <array>
+#include <map>
+#include <memory>
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
 #include "shader.h"
 #include "texture.h"
+#include "texture_array.h"
 #include "material.h"
-#include "light.h"
-#include "camera.h"
+#include "render_state.h"
+#include "frustum.h"
+#include "normal_matrix.h"
+#include "vertex_format.h"
+#include "vertex_layout.h"
+#include "index_buffer.h"
+#include "mesh_optimizer.h"
+
+// Статична геометрія меша (для пакування в спільний буфер, див. IndirectRenderer)
+struct MeshGeometry
+{
+    std::vector<CubeVertex> vertices;
+    std::vector<unsigned int> indices;
+};
 
 class Mesh {
     public:
-        virtual void draw(const glm::mat4& view, const glm::mat4& projection, 
-                         const std::vector<Light>& lights, const glm::vec3& viewPos, 
-                         const Camera& camera) = 0;
+        // Світло береться з LightBuffer, прив'язаного один раз на кадр.
+        // Зміни GL-стану йдуть через context.state, щоб надлишкові відкидались
+        virtual void draw(RenderContext& context) = 0;
+
+        // Лише геометрія, без програми й uniform-ів (глибинний прохід, DepthPrepass).
+        // Позиції мають бути ті самі, що й у draw(), інакше GL_EQUAL відкине пікселі;
+        // меші без перевизначення не можна подавати в DepthPrepass
+        virtual void drawGeometry(RenderContext& /*context*/) {}
+
+        // Опис меша для пакетних рендерерів. Порожня геометрія - меш не можна пакувати
+        virtual MeshGeometry geometry() const { return {}; }
+        virtual glm::mat4 modelMatrix() const { return glm::mat4(1.0f); }
+
+        // Матриця, з якою вершинний шейдер перетворює позиції з буфера (uniform model).
+        // Відрізняється від modelMatrix() лише для квантованих позицій (ModelMesh)
+        virtual glm::mat4 vertexMatrix() const { return modelMatrix(); }
+        virtual Material meshMaterial() const { return Materials::Silver; }
+
+        // Межі у світових координатах для відсікання (BVH, FrustumCuller).
+        // За замовчуванням - з геометрії; мешам, що рахують межі дешевше, варто перевизначити
+        virtual AABB worldBounds() const
+        {
+            MeshGeometry mesh = geometry();
+            if (mesh.vertices.empty())
+                return {glm::vec3(-1.0e30f), glm::vec3(1.0e30f)};
+
+            AABB bounds = {mesh.vertices[0].position, mesh.vertices[0].position};
+            for (const CubeVertex& vertex : mesh.vertices)
+            {
+                bounds.min = glm::min(bounds.min, vertex.position);
+                bounds.max = glm::max(bounds.max, vertex.position);
+            }
+            return bounds.transformed(modelMatrix());
+        }
+
+        // Складові ключа сортування (RenderQueue)
+        virtual unsigned int shaderID() const { return 0; }
+        virtual uint32_t textureSetHash() const { return 0; }
+
         virtual ~Mesh() = default;
 };
 
-struct CubeVertex
+// Дескриптори uniform-змінних, які Cube встановлює щокадру.
+// Розв'язуються один раз у конструкторі, щоб у draw() не було пошуку за іменем
+struct CubeUniforms
 {
-    glm::vec3 position;
-    glm::vec3 color;
-    glm::vec3 normal;
-    glm::vec2 texCoord;
+    Uniform<glm::vec3> viewPos;
+    Uniform<glm::mat4> model;
+    Uniform<glm::mat4> view;
+    Uniform<glm::mat4> projection;
+    Uniform<glm::mat3> normalMatrix;
+    Uniform<bool> uniformScale;
+    Uniform<bool> useTextures;
+    Uniform<float> colorAlpha;
+    std::vector<Uniform<int>> textureSamplers;
+    MaterialUniforms material;
+
+    CubeUniforms() = default;
+
+    CubeUniforms(const Shader& shader, size_t textureCount)
+    : viewPos(shader.uniform<glm::vec3>("viewPos")),
+      model(shader.uniform<glm::mat4>("model")),
+      view(shader.uniform<glm::mat4>("view")),
+      projection(shader.uniform<glm::mat4>("projection")),
+      normalMatrix(shader.uniform<glm::mat3>("normalMatrix")),
+      uniformScale(shader.uniform<bool>("uniformScale")),
+      useTextures(shader.uniform<bool>("useTextures")),
+      colorAlpha(shader.uniform<float>("colorAlpha")),
+      material(shader)
+    {
+        for (size_t i = 0; i < textureCount; ++i)
+        {
+            textureSamplers.push_back(shader.uniform<int>("texture" + std::to_string(i)));
+        }
+    }
+};
+
+// Розкладка вершин куба: 16 байт замість 44, колір вершин шейдери не читають.
+// Одна на всі програми кубів (Cube, CubeBatch, GeometryArena) і їхні варіанти - VAO спільний,
+// тож атрибут, якого не читає одна програма, лишається для інших;
+// шейдер з OCTAHEDRAL_NORMALS з кубами не працює - validateVertexInput його відхиляє
+using CubeLayout = VertexLayout<Attr<Semantic::Position, AttribFormat::Half4>,
+                                Attr<Semantic::Normal, AttribFormat::Snorm10x3>,
+                                Attr<Semantic::TexCoord, AttribFormat::Half2>>;
+
+// GPU-буфери геометрії куба в просторі об'єкта (центр у початку координат).
+// Спільні для всіх кубів з однаковими розміром і кольором вершин, див. Cube::acquireGeometry
+class CubeGeometry
+{
+    public:
+        unsigned int VAO, VBO;
+        IndexBuffer indexBuffer;
+
+        CubeGeometry(const std::vector<CubeVertex>& vertices, const std::vector<unsigned int>& indices)
+        {
+            std::vector<unsigned char> packed = CubeLayout::pack(vertices);
+
+            glGenVertexArrays(1, &VAO);
+            glGenBuffers(1, &VBO);
+
+            glBindVertexArray(VAO);
+
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+
+            indexBuffer.upload(indices, vertices.size());
+
+            CubeLayout::setup();
+
+            glBindVertexArray(0);
+        }
+
+        ~CubeGeometry()
+        {
+            glDeleteVertexArrays(1, &VAO);
+            glDeleteBuffers(1, &VBO);
+        }
+
+        CubeGeometry(const CubeGeometry&) = delete;
+        CubeGeometry& operator=(const CubeGeometry&) = delete;
 };
 
 class Cube : public Mesh
 {
     public:
-        unsigned int VAO, VBO, EBO;
+        // Геометрія в просторі об'єкта; положення задає лише modelMatrix()
+        std::shared_ptr<CubeGeometry> sharedGeometry;
         Shader& shader;
         std::vector<Texture*> textures;
+        // Шейдер з TEXTURE_ARRAY: шар задає material.textureLayer, textures порожній
+        TextureArray* textureArray = nullptr;
         glm::vec3 position;
         glm::vec3 size;
+        glm::vec3 color;
         bool showTex;
         Material material;
+        CubeUniforms uniforms;
+
+        // Матриця нормалей для modelMatrix(); оновлювати разом з трансформацією
+        GpuNormalMatrix normalMatrix;
         
         Cube(
             const glm::vec3& pos,
@@ -46,144 +182,180 @@ class Cube : public Mesh
             const std::vector<Texture*>& texs,
             const Material& mat = Materials::Silver, 
             bool showTex = true)
-        : position(pos), shader(shaderRef), size(cubeSize), material(mat),showTex(showTex)
+        : position(pos), shader(shaderRef), size(cubeSize), color(color), material(mat),showTex(showTex)
         {
             std::cout << "CUBE::START_INIT" << std::endl;
             for (auto tex : texs)
             {
                 textures.push_back(tex);
             }
-            auto vertices = generateCubeVertices(position, size, color);
-            auto indicies = generateCubeIndices();
-
-            glGenVertexArrays(1, &VAO);
-            glGenBuffers(1, &VBO);
-            glGenBuffers(1, &EBO);
-
-            glBindVertexArray(VAO);
-
-            glBindBuffer(GL_ARRAY_BUFFER, VBO);
-            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(CubeVertex), vertices.data(), GL_STATIC_DRAW);
-
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicies.size() * sizeof(unsigned int), indicies.data(), GL_STATIC_DRAW);
-
-            // POSITION
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(CubeVertex), (void*)offsetof(CubeVertex, position));
-            glEnableVertexAttribArray(0);
-
-            // COLOR
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(CubeVertex), (void*)offsetof(CubeVertex, color));
-            glEnableVertexAttribArray(1);
-
-            // NORMAL
-            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(CubeVertex), (void*)offsetof(CubeVertex, normal));
-            glEnableVertexAttribArray(2);
-
-            // TEXTURE
-            glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(CubeVertex), (void*)offsetof(CubeVertex, texCoord));
-            glEnableVertexAttribArray(3);
-
-            glBindVertexArray(0);
+            uniforms = CubeUniforms(shader, textures.size());
+            glm::mat4 model = modelMatrix();
+            computeNormalMatrices(&model, 1, &normalMatrix);
+            inputValid = validateVertexInput<CubeLayout>(shader, "CUBE");
+            sharedGeometry = acquireGeometry(size, color);
             std::cout << "CUBE::END_INIT" << std::endl;
         };
+
+        // Програма для проходу з іншим варіантом шейдера (RenderContext::variant).
+        // Входи вершин мають збігатися з основною програмою - VAO спільний
+        void setVariant(ShaderVariant variantId, Shader& variantShader)
+        {
+            variants[static_cast<int>(variantId)] = {&variantShader, CubeUniforms(variantShader, textures.size()),
+                                                     validateVertexInput<CubeLayout>(variantShader, "CUBE")};
+        }
         
-        void draw(const glm::mat4& view, const glm::mat4& projection, 
-                 const std::vector<Light>& lights, const glm::vec3& viewPos,
-                 const Camera& camera) override
+        void draw(RenderContext& context) override
         {
-            shader.use();
-
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
-
-            shader.setVec3("viewPos", viewPos);
-            shader.setMat4("model", model);
-            shader.setMat4("view", view);
-            shader.setMat4("projection", projection);
-            
-            // Встановлюємо кількість джерел світла
-            int numLights = static_cast<int>(lights.size());
-            shader.setInt("numLights", numLights);
-            
-            static bool debugPrinted = false;
-            
-            // Передаємо всі джерела світла в шейдер
-            for (size_t i = 0; i < lights.size(); ++i) {
-                // Якщо це Spotlight, оновлюємо його позицію та напрямок
-                Light currentLight = lights[i];
-                if (currentLight.type == LightType::SPOT) {
-                    currentLight.position = camera.Position;
-                    currentLight.direction = camera.Front;
-                    
-                    if (!debugPrinted) {
-                        std::cout << "Spotlight оновлено: pos=(" 
-                                  << currentLight.position.x << "," 
-                                  << currentLight.position.y << "," 
-                                  << currentLight.position.z << ") dir=("
-                                  << currentLight.direction.x << ","
-                                  << currentLight.direction.y << ","
-                                  << currentLight.direction.z << ")" << std::endl;
-                        debugPrinted = true;
-                    }
+            GLStateCache& state = context.state;
+            ProgramVariant& variant = variants[static_cast<int>(context.variant)];
+            Shader& program = variant.shader ? *variant.shader : shader;
+            CubeUniforms& programUniforms = variant.shader ? variant.uniforms : uniforms;
+            // Програма не читає CubeLayout - малювати нема чого (помилка вже в журналі)
+            if (!(variant.shader ? variant.inputValid : inputValid))
+                return;
+
+            state.useProgram(program.ID);
+
+            // Uniform-и кадру та номери текстурних блоків - раз на кадр для програми
+            if (state.firstUseThisFrame(program.ID))
+            {
+                programUniforms.viewPos.set(context.viewPos);
+                programUniforms.view.set(context.view);
+                programUniforms.projection.set(context.projection);
+
+                for (unsigned int i = 0; i < programUniforms.textureSamplers.size(); i++)
+                {
+                    programUniforms.textureSamplers[i].set(static_cast<int>(i));
                 }
-                
-                // Передача uniform у шейдер
-                currentLight.setShaderUniforms(shader, "lights", static_cast<int>(i));
             }
-            
-            material.setShaderUniforms(shader);
+
+            programUniforms.model.set(modelMatrix());
+            programUniforms.uniformScale.set(normalMatrix.uniformScale());
+            if (!normalMatrix.uniformScale())
+            {
+                programUniforms.normalMatrix.set(normalMatrix.matrix());
+            }
+
+            if (state.materialChanged(program.ID, material))
+            {
+                material.setShaderUniforms(programUniforms.material);
+            }
 
             // Перевіряємо чи є текстури
-            bool hasTextures = !textures.empty();
-            shader.setBool("useTextures", hasTextures && showTex);
+            bool hasTextures = !textures.empty() || textureArray;
+            programUniforms.useTextures.set(hasTextures && showTex);
 
-            if (hasTextures)
+            // Масив - той самий ID для всіх кубів, кеш стану відкидає повторні прив'язки
+            if (textureArray)
             {
-                for (unsigned int i = 0; i < textures.size(); i++)
-                {
-                    glActiveTexture(GL_TEXTURE0 + i);
-                    textures[i]->bind();
-                    shader.setInt("texture" + std::to_string(i), i);
-                }
+                state.bindTexture(TEXTURE_ARRAY_UNIT, textureArray->ID, GL_TEXTURE_2D_ARRAY, textureArray->sampler);
+            }
+            for (unsigned int i = 0; i < textures.size(); i++)
+            {
+                state.bindTexture(i, textures[i]->ID, GL_TEXTURE_2D, textures[i]->sampler);
             }
 
             if (showTex && hasTextures)
             {
-                shader.setFloat("colorAlpha", 0.0f);
+                programUniforms.colorAlpha.set(0.0f);
             }
             else
             {
-                shader.setFloat("colorAlpha", 1.0f);
+                programUniforms.colorAlpha.set(1.0f);
             }
 
-            glBindVertexArray(VAO);
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
+            drawGeometry(context);
         }
 
-        ~Cube() override
+        void drawGeometry(RenderContext& context) override
         {
-            glDeleteVertexArrays(1, &VAO);
-            glDeleteBuffers(1, &VBO);
-            glDeleteBuffers(1, &EBO);
-        };
+            GLStateCache& state = context.state;
+            state.bindVertexArray(sharedGeometry->VAO);
+            glDrawElements(GL_TRIANGLES, sharedGeometry->indexBuffer.count, sharedGeometry->indexBuffer.type, 0);
+            state.stats.drawCalls++;
+        }
 
-    private:
-        std::vector<CubeVertex> generateCubeVertices(glm::vec3 position, glm::vec3 size, glm::vec3 color){
+        MeshGeometry geometry() const override
+        {
+            return buildGeometry(size, color);
+        }
+
+        glm::mat4 modelMatrix() const override
+        {
+            return glm::translate(glm::mat4(1.0f), position);
+        }
+
+        Material meshMaterial() const override
+        {
+            return material;
+        }
+
+        // Вершини куба лежать у межах ± size / 2 у просторі об'єкта (див. generateCubeVertices)
+        AABB worldBounds() const override
+        {
+            AABB local = {size * -0.5f, size * 0.5f};
+            return local.transformed(modelMatrix());
+        }
+
+        unsigned int shaderID() const override
+        {
+            return shader.ID;
+        }
+
+        uint32_t textureSetHash() const override
+        {
+            uint32_t hash = 2166136261u;
+            if (textureArray)
+                hash = (hash ^ textureArray->ID) * 16777619u;
+            for (const Texture* texture : textures)
+            {
+                hash = (hash ^ texture->ID) * 16777619u;
+            }
+            return hash;
+        }
+
+        // Буфери для розміру й кольору: наявні, якщо ще живий хоч один такий куб, інакше нові.
+        // Кеш тримає слабкі посилання, тож геометрія звільняється разом з останнім кубом
+        static std::shared_ptr<CubeGeometry> acquireGeometry(const glm::vec3& size, const glm::vec3& color)
+        {
+            static std::map<std::array<float, 6>, std::weak_ptr<CubeGeometry>> cache;
+
+            std::array<float, 6> key = {size.x, size.y, size.z, color.x, color.y, color.z};
+            std::shared_ptr<CubeGeometry> geometry = cache[key].lock();
+            if (!geometry)
+            {
+                MeshGeometry mesh = buildGeometry(size, color);
+                geometry = std::make_shared<CubeGeometry>(mesh.vertices, mesh.indices);
+                cache[key] = geometry;
+            }
+            return geometry;
+        }
+
+        // Вершини й індекси куба з порядком трикутників після MeshOptimizer - вхід для всіх GPU-буферів куба
+        static MeshGeometry buildGeometry(const glm::vec3& size, const glm::vec3& color)
+        {
+            MeshGeometry mesh = {generateCubeVertices(size, color), generateCubeIndices()};
+            MeshOptimizer::optimize(mesh.indices, mesh.vertices);
+            return mesh;
+        }
+
+        // Геометрія куба в просторі об'єкта (24 вершини, по 4 на грань) - спільна з CubeBatch
+        static std::vector<CubeVertex> generateCubeVertices(glm::vec3 size, glm::vec3 color){
             std::cout << "CUBE::START_VERTEX" << std::endl;
             float halfx = size.x / 2.0f;
             float halfy = size.y / 2.0f;
             float halfz = size.z / 2.0f;
 
             glm::vec3 p[8] = {
-                {position.x - halfx, position.y - halfy, position.z + halfz},
-                {position.x + halfx, position.y - halfy, position.z + halfz},
-                {position.x + halfx, position.y + halfy, position.z + halfz},
-                {position.x - halfx, position.y + halfy, position.z + halfz},
-                {position.x - halfx, position.y - halfy, position.z - halfz},
-                {position.x + halfx, position.y - halfy, position.z - halfz},
-                {position.x + halfx, position.y + halfy, position.z - halfz},
-                {position.x - halfx, position.y + halfy, position.z - halfz},
+                {-halfx, -halfy,  halfz},
+                { halfx, -halfy,  halfz},
+                { halfx,  halfy,  halfz},
+                {-halfx,  halfy,  halfz},
+                {-halfx, -halfy, -halfz},
+                { halfx, -halfy, -halfz},
+                { halfx,  halfy, -halfz},
+                {-halfx,  halfy, -halfz},
             };
 
             glm::vec3 normals[] = {
@@ -244,7 +416,7 @@ class Cube : public Mesh
             return vertices;
         }
 
-        std::vector<unsigned int> generateCubeIndices() {
+        static std::vector<unsigned int> generateCubeIndices() {
             std::cout << "CUBE::START_INDICES" << std::endl;
             std::vector<unsigned int> indices;
             for (int i = 0; i < 6; ++i) {
@@ -259,6 +431,16 @@ class Cube : public Mesh
             std::cout << "CUBE::END_INDICES" << std::endl;
             return indices;
         }
+
+    private:
+        struct ProgramVariant
+        {
+            Shader* shader = nullptr;
+            CubeUniforms uniforms;
+            bool inputValid = false;
+        };
+        ProgramVariant variants[SHADER_VARIANT_COUNT];
+        bool inputValid = false;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,319 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "vertex_format.h"
+
+// Переупорядкування трикутників під час завантаження мешів:
+//  - optimizeVertexCache: жадібний алгоритм Forsyth ("Linear-Speed Vertex Cache Optimisation"),
+//    менше повторних запусків вершинного шейдера;
+//  - optimizeOverdraw: кластери з майже незміненим ACMR сортуються "ззовні всередину"
+//    (Sander, Nehab, Barczak), щоб зовнішні поверхні закривали внутрішні раніше
+namespace MeshOptimizer
+{
+    const int CACHE_SIZE = 32;
+    const unsigned int FIFO_CACHE_SIZE = 16;
+
+    // Оцінка вершини: позиція в LRU-кеші + бонус за малу кількість трикутників, що лишились
+    inline float vertexScore(int cachePosition, unsigned int remaining)
+    {
+        if (remaining == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            // Три вершини останнього трикутника - фіксована оцінка, щоб не "прилипати" до нього
+            if (cachePosition < 3)
+                score = 0.75f;
+            else
+                score = std::pow(1.0f - float(cachePosition - 3) / float(CACHE_SIZE - 3), 1.5f);
+        }
+        return score + 2.0f / std::sqrt(float(remaining));
+    }
+
+    // Промахи FIFO-кешу вершин на трикутник, ACMR (3.0 - жодна вершина не з кешу, ~0.5-0.7 - добре)
+    inline float averageCacheMissRatio(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                       unsigned int cacheSize = FIFO_CACHE_SIZE)
+    {
+        if (indices.size() < 3)
+            return 0.0f;
+
+        std::vector<unsigned int> stamps(vertexCount, 0);
+        unsigned int time = cacheSize + 1;
+        size_t misses = 0;
+        for (unsigned int index : indices)
+        {
+            if (time - stamps[index] > cacheSize)
+            {
+                stamps[index] = time++;
+                misses++;
+            }
+        }
+        return float(misses) / float(indices.size() / 3);
+    }
+
+    inline void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+    {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+            return;
+
+        // Суміжність вершина -> трикутники (активні - перші remaining[v] у діапазоні вершини)
+        std::vector<unsigned int> remaining(vertexCount, 0);
+        for (unsigned int index : indices)
+        {
+            remaining[index]++;
+        }
+
+        std::vector<unsigned int> offsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            offsets[v + 1] = offsets[v] + remaining[v];
+        }
+
+        std::vector<unsigned int> adjacency(indices.size());
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            adjacency[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            vertexScores[v] = vertexScore(-1, remaining[v]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                vertexScores[indices[t * 3 + 2]];
+        }
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<unsigned int> output;
+        output.reserve(indices.size());
+
+        std::vector<unsigned int> cache, nextCache;
+        cache.reserve(CACHE_SIZE + 3);
+        nextCache.reserve(CACHE_SIZE + 3);
+
+        size_t scanCursor = 0;
+        long best = -1;
+
+        while (output.size() < indices.size())
+        {
+            // Жоден трикутник у кеші не лишився - найкращий серед усіх невиведених
+            if (best < 0)
+            {
+                while (scanCursor < triangleCount && emitted[scanCursor])
+                    scanCursor++;
+
+                float bestScore = -1.0f;
+                for (size_t t = scanCursor; t < triangleCount; ++t)
+                {
+                    if (!emitted[t] && triangleScores[t] > bestScore)
+                    {
+                        bestScore = triangleScores[t];
+                        best = static_cast<long>(t);
+                    }
+                }
+            }
+
+            const unsigned int* triangle = &indices[best * 3];
+            output.insert(output.end(), triangle, triangle + 3);
+            emitted[best] = true;
+
+            // Вершини трикутника - на початок кешу, прибрати трикутник із суміжності
+            nextCache.assign(triangle, triangle + 3);
+            for (int k = 0; k < 3; ++k)
+            {
+                unsigned int v = triangle[k];
+                unsigned int* begin = &adjacency[offsets[v]];
+                unsigned int* end = begin + remaining[v];
+                unsigned int* found = std::find(begin, end, static_cast<unsigned int>(best));
+                if (found != end)
+                {
+                    std::swap(*found, *(end - 1));
+                    remaining[v]--;
+                }
+            }
+            for (unsigned int v : cache)
+            {
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                    nextCache.push_back(v);
+            }
+
+            // Нові оцінки вершин кешу (витіснені - з позицією -1) і їхніх трикутників
+            for (size_t i = 0; i < nextCache.size(); ++i)
+            {
+                unsigned int v = nextCache[i];
+                cachePosition[v] = i < size_t(CACHE_SIZE) ? static_cast<int>(i) : -1;
+                vertexScores[v] = vertexScore(cachePosition[v], remaining[v]);
+            }
+
+            best = -1;
+            float bestScore = -1.0f;
+            for (unsigned int v : nextCache)
+            {
+                for (unsigned int a = 0; a < remaining[v]; ++a)
+                {
+                    unsigned int t = adjacency[offsets[v] + a];
+                    float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                  vertexScores[indices[t * 3 + 2]];
+                    triangleScores[t] = score;
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        best = t;
+                    }
+                }
+            }
+
+            if (nextCache.size() > size_t(CACHE_SIZE))
+                nextCache.resize(CACHE_SIZE);
+            cache.swap(nextCache);
+        }
+
+        indices.swap(output);
+    }
+
+    // threshold - на скільки кластер може погіршити ACMR заради дрібнішого поділу (1.05 = 5%).
+    // Викликати після optimizeVertexCache: кластери - неперервні відрізки її порядку
+    inline void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<CubeVertex>& vertices,
+                                 float threshold = 1.05f)
+    {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+            return;
+
+        // 1. Жорсткі межі: трикутник з трьома промахами FIFO-кешу починає новий кластер
+        std::vector<unsigned int> stamps(vertices.size(), 0);
+        unsigned int time = FIFO_CACHE_SIZE + 1;
+        auto missesFor = [&](size_t t) {
+            unsigned int misses = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                unsigned int v = indices[t * 3 + k];
+                if (time - stamps[v] > FIFO_CACHE_SIZE)
+                {
+                    stamps[v] = time++;
+                    misses++;
+                }
+            }
+            return misses;
+        };
+
+        std::vector<size_t> hardStarts;
+        std::vector<unsigned int> triangleMisses(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            triangleMisses[t] = missesFor(t);
+            if (t == 0 || triangleMisses[t] == 3)
+                hardStarts.push_back(t);
+        }
+        hardStarts.push_back(triangleCount);
+
+        // 2. М'які межі всередині жорсткого кластера: частина, чий ACMR (з порожнім кешем)
+        // не гірший за ACMR усього кластера більш ніж у threshold разів, стає окремим кластером
+        std::vector<size_t> starts;
+        for (size_t h = 0; h + 1 < hardStarts.size(); ++h)
+        {
+            size_t first = hardStarts[h], last = hardStarts[h + 1];
+            unsigned int clusterMisses = 0;
+            for (size_t t = first; t < last; ++t)
+            {
+                clusterMisses += triangleMisses[t];
+            }
+            float clusterAcmr = float(clusterMisses) / float(last - first);
+
+            size_t start = first;
+            time += FIFO_CACHE_SIZE + 1;
+            unsigned int misses = 0;
+            for (size_t t = first; t < last; ++t)
+            {
+                misses += missesFor(t);
+                float acmr = float(misses) / float(t - start + 1);
+                if (t + 1 < last && acmr <= clusterAcmr * threshold)
+                {
+                    starts.push_back(start);
+                    start = t + 1;
+                    misses = 0;
+                    time += FIFO_CACHE_SIZE + 1;
+                }
+            }
+            starts.push_back(start);
+        }
+        starts.push_back(triangleCount);
+
+        // 3. Сортування кластерів: спершу ті, що дивляться назовні від центру меша
+        glm::vec3 meshCenter(0.0f);
+        float meshArea = 0.0f;
+        struct Cluster
+        {
+            size_t first, last;
+            glm::vec3 center;
+            glm::vec3 normal;
+            float area;
+            float sortKey;
+        };
+        std::vector<Cluster> clusters;
+        for (size_t c = 0; c + 1 < starts.size(); ++c)
+        {
+            Cluster cluster = {starts[c], starts[c + 1], glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 0.0f};
+            for (size_t t = cluster.first; t < cluster.last; ++t)
+            {
+                const glm::vec3& a = vertices[indices[t * 3]].position;
+                const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+                const glm::vec3& c2 = vertices[indices[t * 3 + 2]].position;
+                glm::vec3 n = glm::cross(b - a, c2 - a);
+                float area = glm::length(n);
+                cluster.center += (a + b + c2) * (area / 3.0f);
+                cluster.normal += n;
+                cluster.area += area;
+            }
+            meshCenter += cluster.center;
+            meshArea += cluster.area;
+            clusters.push_back(cluster);
+        }
+        if (meshArea > 0.0f)
+            meshCenter = meshCenter * (1.0f / meshArea);
+
+        for (Cluster& cluster : clusters)
+        {
+            glm::vec3 center = cluster.area > 0.0f ? cluster.center * (1.0f / cluster.area) : meshCenter;
+            float length = glm::length(cluster.normal);
+            glm::vec3 normal = length > 0.0f ? cluster.normal * (1.0f / length) : glm::vec3(0.0f);
+            cluster.sortKey = glm::dot(center - meshCenter, normal);
+        }
+
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+            return a.sortKey > b.sortKey;
+        });
+
+        std::vector<unsigned int> output;
+        output.reserve(indices.size());
+        for (const Cluster& cluster : clusters)
+        {
+            output.insert(output.end(), indices.begin() + cluster.first * 3, indices.begin() + cluster.last * 3);
+        }
+        indices.swap(output);
+    }
+
+    // Повна обробка меша при завантаженні: кеш вершин, потім перекриття
+    inline void optimize(std::vector<unsigned int>& indices, const std::vector<CubeVertex>& vertices)
+    {
+        optimizeVertexCache(indices, vertices.size());
+        optimizeOverdraw(indices, vertices);
+    }
+}
+
+#endif
@@ -0,0 +1,708 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <glad/glad.h>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <assimp/DefaultIOSystem.h>
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "shader.h"
+#include "texture.h"
+#include "texture_cache.h"
+#include "material.h"
+#include "mesh.h"
+#include "frustum.h"
+#include "normal_matrix.h"
+#include "index_buffer.h"
+#include "mesh_optimizer.h"
+#include "mapped_file.h"
+#include "vertex_layout.h"
+
+// Розкладка вершин моделей: позиції квантовані відносно меж моделі (unorm16),
+// нормалі - 10 біт, uv - half. 16 байт на вершину
+using ModelLayout = VertexLayout<Attr<Semantic::Position, AttribFormat::Unorm16x4>,
+                                 Attr<Semantic::Normal, AttribFormat::Snorm10x3>,
+                                 Attr<Semantic::TexCoord, AttribFormat::Half2>>;
+
+// Бінарний кеш моделі (<модель>.meshcache):
+//   ModelCacheHeader | ModelCacheMesh[meshCount] | ModelCacheMaterial[materialCount] |
+//   ModelCacheDependency[dependencyCount] | вершини в ModelLayout | індекси в indexType
+// Вершини й індекси вже в GPU-форматі: при збігу хешів вихідного файлу і всіх файлів, які
+// читав імпортер (.mtl, .bin glTF, ...), кеш відображається в пам'ять і передається
+// в glBufferData як є, assimp не викликається
+const uint32_t MODEL_CACHE_MAGIC = 0x4D435645;  // "EVCM"
+const uint32_t MODEL_CACHE_VERSION = 2;
+
+struct ModelCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t meshCount;
+    uint32_t materialCount;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t vertexStride;
+    uint32_t indexType;     // GL_UNSIGNED_SHORT / GL_UNSIGNED_INT - за найбільшим мешем (baseVertex)
+    glm::vec3 boundsMin;    // позиція = boundsMin + unorm * decodeScale(boundsMin, boundsMax)
+    glm::vec3 boundsMax;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint32_t dependencyCount;
+    uint32_t reserved;
+};
+
+// Меш моделі - діапазон спільних буферів з одним матеріалом
+struct ModelCacheMesh
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t baseVertex;
+    uint32_t vertexCount;
+    uint32_t materialIndex;
+    glm::vec3 boundsMin;    // у просторі моделі
+    glm::vec3 boundsMax;
+};
+
+struct ModelCacheMaterial
+{
+    glm::vec3 albedo;
+    float metallic;
+    float roughness;
+    float ao;
+    float alpha;
+    char diffuseTexture[256];   // шлях відносно файлу моделі; порожній - без текстури
+};
+
+// Файл, який імпортер прочитав, крім самої моделі, і хеш його вмісту на момент збирання
+struct ModelCacheDependency
+{
+    char path[256];             // як його відкривав імпортер (відносно робочого каталогу)
+    uint64_t hash;
+};
+
+static_assert(sizeof(ModelCacheHeader) == 88, "ModelCacheHeader layout is part of the cache format");
+static_assert(sizeof(ModelCacheMesh) == 44, "ModelCacheMesh layout is part of the cache format");
+static_assert(sizeof(ModelCacheMaterial) == 284, "ModelCacheMaterial layout is part of the cache format");
+static_assert(sizeof(ModelCacheDependency) == 264, "ModelCacheDependency layout is part of the cache format");
+
+namespace ModelCache
+{
+    // Розмах меж для квантування; нульова вісь (плаский меш) не повинна давати ділення на нуль
+    inline glm::vec3 decodeScale(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        return glm::max(boundsMax - boundsMin, glm::vec3(1.0e-6f));
+    }
+
+    inline const ModelCacheHeader& header(const unsigned char* blob)
+    {
+        return *reinterpret_cast<const ModelCacheHeader*>(blob);
+    }
+
+    inline const ModelCacheMesh* meshes(const unsigned char* blob)
+    {
+        return reinterpret_cast<const ModelCacheMesh*>(blob + sizeof(ModelCacheHeader));
+    }
+
+    inline const ModelCacheMaterial* materials(const unsigned char* blob)
+    {
+        return reinterpret_cast<const ModelCacheMaterial*>(blob + sizeof(ModelCacheHeader) +
+                                                            header(blob).meshCount * sizeof(ModelCacheMesh));
+    }
+
+    inline const ModelCacheDependency* dependencies(const unsigned char* blob)
+    {
+        return reinterpret_cast<const ModelCacheDependency*>(
+            reinterpret_cast<const unsigned char*>(materials(blob)) +
+            header(blob).materialCount * sizeof(ModelCacheMaterial));
+    }
+
+    // Хеш вмісту файлу; відсутній або порожній файл - хеш порожнього вмісту
+    inline uint64_t hashFile(const std::string& path)
+    {
+        MappedFile file(path);
+        return file.valid() ? hashBytes(file.data, file.size) : hashBytes(nullptr, 0);
+    }
+
+    // Файлова система assimp, що запам'ятовує кожен відкритий файл
+    class RecordingIOSystem : public Assimp::DefaultIOSystem
+    {
+        public:
+            std::vector<std::string> opened;
+
+            Assimp::IOStream* Open(const char* file, const char* mode = "rb") override
+            {
+                Assimp::IOStream* stream = Assimp::DefaultIOSystem::Open(file, mode);
+                if (stream && std::find(opened.begin(), opened.end(), file) == opened.end())
+                    opened.push_back(file);
+                return stream;
+            }
+    };
+
+    // Кеш придатний, якщо зібраний з того самого вихідного файлу цією версією формату,
+    // має хоч один матеріал (меші посилаються на materialCount - 1 як на запасний),
+    // всі розділи лежать у межах файлу і жоден із залежних файлів не змінився
+    inline bool valid(const unsigned char* blob, size_t size, uint64_t sourceHash)
+    {
+        if (size < sizeof(ModelCacheHeader))
+            return false;
+
+        const ModelCacheHeader& h = header(blob);
+        if (h.magic != MODEL_CACHE_MAGIC || h.version != MODEL_CACHE_VERSION || h.sourceHash != sourceHash)
+            return false;
+        if (h.vertexStride != static_cast<uint32_t>(ModelLayout::stride) ||
+            (h.indexType != GL_UNSIGNED_SHORT && h.indexType != GL_UNSIGNED_INT) || h.materialCount == 0)
+            return false;
+
+        uint64_t tables = sizeof(ModelCacheHeader) + uint64_t(h.meshCount) * sizeof(ModelCacheMesh) +
+                          uint64_t(h.materialCount) * sizeof(ModelCacheMaterial) +
+                          uint64_t(h.dependencyCount) * sizeof(ModelCacheDependency);
+        uint64_t vertexEnd = h.vertexOffset + uint64_t(h.vertexCount) * h.vertexStride;
+        uint64_t indexEnd = h.indexOffset + uint64_t(h.indexCount) * indexSize(h.indexType);
+        if (tables > h.vertexOffset || vertexEnd > h.indexOffset || indexEnd > size)
+            return false;
+
+        const ModelCacheMesh* m = meshes(blob);
+        for (uint32_t i = 0; i < h.meshCount; ++i)
+        {
+            if (uint64_t(m[i].firstIndex) + m[i].indexCount > h.indexCount ||
+                uint64_t(m[i].baseVertex) + m[i].vertexCount > h.vertexCount)
+                return false;
+        }
+
+        const ModelCacheDependency* d = dependencies(blob);
+        for (uint32_t i = 0; i < h.dependencyCount; ++i)
+        {
+            std::string path(d[i].path, strnlen(d[i].path, sizeof(d[i].path)));
+            if (hashFile(path) != d[i].hash)
+                return false;
+        }
+        return true;
+    }
+
+    inline ModelCacheMaterial convertMaterial(const aiMaterial& source)
+    {
+        ModelCacheMaterial material = {};
+        material.albedo = glm::vec3(0.8f);
+        material.metallic = 0.0f;
+        material.roughness = 0.5f;
+        material.ao = 1.0f;
+        material.alpha = 1.0f;
+
+        // PBR-ключі (glTF) мають пріоритет над класичними (OBJ/FBX)
+        aiColor4D color;
+        if (source.Get(AI_MATKEY_BASE_COLOR, color) == AI_SUCCESS ||
+            source.Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS)
+        {
+            material.albedo = glm::vec3(color.r, color.g, color.b);
+        }
+        source.Get(AI_MATKEY_METALLIC_FACTOR, material.metallic);
+        source.Get(AI_MATKEY_ROUGHNESS_FACTOR, material.roughness);
+        source.Get(AI_MATKEY_OPACITY, material.alpha);
+
+        aiString texture;
+        if (source.GetTexture(aiTextureType_BASE_COLOR, 0, &texture) == AI_SUCCESS ||
+            source.GetTexture(aiTextureType_DIFFUSE, 0, &texture) == AI_SUCCESS)
+        {
+            std::strncpy(material.diffuseTexture, texture.C_Str(), sizeof(material.diffuseTexture) - 1);
+        }
+        return material;
+    }
+
+    // Імпорт через assimp і збирання кешу в пам'яті. Порожній результат - помилка імпорту
+    inline std::vector<unsigned char> build(const std::string& path, uint64_t sourceHash)
+    {
+        Assimp::Importer importer;
+        // Власник - importer
+        RecordingIOSystem* io = new RecordingIOSystem();
+        importer.SetIOHandler(io);
+        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+                                                       aiProcess_GenSmoothNormals | aiProcess_PreTransformVertices |
+                                                       aiProcess_SortByPType | aiProcess_FindDegenerates);
+        if (!scene || !scene->mRootNode || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE))
+        {
+            std::cout << "ERROR::MODEL::IMPORT_FAILED " << path << ": " << importer.GetErrorString() << std::endl;
+            return {};
+        }
+
+        // Меші - після PreTransformVertices уже в просторі моделі
+        std::vector<MeshGeometry> geometries;
+        std::vector<ModelCacheMesh> meshes;
+        AABB bounds = AABB::empty();
+        size_t vertexCount = 0, indexCount = 0, maxMeshVertices = 0;
+
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+        {
+            const aiMesh* source = scene->mMeshes[i];
+            if (!(source->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) || source->mNumVertices == 0)
+                continue;
+
+            MeshGeometry geometry;
+            geometry.vertices.resize(source->mNumVertices);
+            AABB meshBounds = AABB::empty();
+            for (unsigned int v = 0; v < source->mNumVertices; ++v)
+            {
+                CubeVertex& vertex = geometry.vertices[v];
+                vertex.position = glm::vec3(source->mVertices[v].x, source->mVertices[v].y, source->mVertices[v].z);
+                vertex.color = glm::vec3(1.0f);
+                vertex.normal = source->HasNormals()
+                    ? glm::vec3(source->mNormals[v].x, source->mNormals[v].y, source->mNormals[v].z)
+                    : glm::vec3(0.0f, 1.0f, 0.0f);
+                vertex.texCoord = source->HasTextureCoords(0)
+                    ? glm::vec2(source->mTextureCoords[0][v].x, source->mTextureCoords[0][v].y)
+                    : glm::vec2(0.0f);
+                meshBounds.expand(vertex.position);
+            }
+
+            geometry.indices.reserve(source->mNumFaces * 3);
+            for (unsigned int f = 0; f < source->mNumFaces; ++f)
+            {
+                const aiFace& face = source->mFaces[f];
+                if (face.mNumIndices == 3)
+                    geometry.indices.insert(geometry.indices.end(), face.mIndices, face.mIndices + 3);
+            }
+            if (geometry.indices.empty())
+                continue;
+
+            float acmrBefore = MeshOptimizer::averageCacheMissRatio(geometry.indices, geometry.vertices.size());
+            MeshOptimizer::optimize(geometry.indices, geometry.vertices);
+            float acmrAfter = MeshOptimizer::averageCacheMissRatio(geometry.indices, geometry.vertices.size());
+            std::cout << "MODEL::MESH " << i << ": " << geometry.indices.size() / 3 << " triangles, ACMR "
+                      << acmrBefore << " -> " << acmrAfter << std::endl;
+
+            ModelCacheMesh mesh;
+            mesh.firstIndex = static_cast<uint32_t>(indexCount);
+            mesh.indexCount = static_cast<uint32_t>(geometry.indices.size());
+            mesh.baseVertex = static_cast<int32_t>(vertexCount);
+            mesh.vertexCount = static_cast<uint32_t>(geometry.vertices.size());
+            mesh.materialIndex = std::min(source->mMaterialIndex, scene->mNumMaterials ? scene->mNumMaterials - 1 : 0u);
+            mesh.boundsMin = meshBounds.min;
+            mesh.boundsMax = meshBounds.max;
+
+            bounds.expand(meshBounds);
+            vertexCount += geometry.vertices.size();
+            indexCount += geometry.indices.size();
+            maxMeshVertices = std::max(maxMeshVertices, geometry.vertices.size());
+            meshes.push_back(mesh);
+            geometries.push_back(std::move(geometry));
+        }
+
+        if (meshes.empty())
+        {
+            std::cout << "ERROR::MODEL::NO_TRIANGLE_MESHES " << path << std::endl;
+            return {};
+        }
+
+        std::vector<ModelCacheMaterial> materials;
+        for (unsigned int i = 0; i < scene->mNumMaterials; ++i)
+        {
+            materials.push_back(convertMaterial(*scene->mMaterials[i]));
+        }
+        if (materials.empty())
+            materials.push_back(convertMaterial(aiMaterial()));
+
+        // Сама модель перевіряється за sourceHash; решта прочитаних файлів - окремими записами
+        std::vector<ModelCacheDependency> dependencies;
+        for (const std::string& opened : io->opened)
+        {
+            if (opened == path)
+                continue;
+            ModelCacheDependency dependency = {};
+            if (opened.size() >= sizeof(dependency.path))
+                std::cout << "WARNING::MODEL::DEPENDENCY_PATH_TOO_LONG " << opened << std::endl;
+            std::strncpy(dependency.path, opened.c_str(), sizeof(dependency.path) - 1);
+            dependency.hash = hashFile(opened);
+            dependencies.push_back(dependency);
+        }
+
+        ModelCacheHeader h = {};
+        h.magic = MODEL_CACHE_MAGIC;
+        h.version = MODEL_CACHE_VERSION;
+        h.sourceHash = sourceHash;
+        h.meshCount = static_cast<uint32_t>(meshes.size());
+        h.materialCount = static_cast<uint32_t>(materials.size());
+        h.vertexCount = static_cast<uint32_t>(vertexCount);
+        h.indexCount = static_cast<uint32_t>(indexCount);
+        h.vertexStride = static_cast<uint32_t>(ModelLayout::stride);
+        h.indexType = indexTypeFor(maxMeshVertices);
+        h.boundsMin = bounds.min;
+        h.boundsMax = bounds.max;
+        h.dependencyCount = static_cast<uint32_t>(dependencies.size());
+
+        size_t tables = sizeof(ModelCacheHeader) + meshes.size() * sizeof(ModelCacheMesh) +
+                        materials.size() * sizeof(ModelCacheMaterial) +
+                        dependencies.size() * sizeof(ModelCacheDependency);
+        h.vertexOffset = (tables + 15) & ~size_t(15);
+        h.indexOffset = (h.vertexOffset + vertexCount * ModelLayout::stride + 15) & ~uint64_t(15);
+
+        std::vector<unsigned char> blob(h.indexOffset + indexCount * indexSize(h.indexType), 0);
+        std::memcpy(blob.data(), &h, sizeof(h));
+        std::memcpy(blob.data() + sizeof(h), meshes.data(), meshes.size() * sizeof(ModelCacheMesh));
+        std::memcpy(blob.data() + sizeof(h) + meshes.size() * sizeof(ModelCacheMesh), materials.data(),
+                    materials.size() * sizeof(ModelCacheMaterial));
+        std::memcpy(blob.data() + sizeof(h) + meshes.size() * sizeof(ModelCacheMesh) +
+                    materials.size() * sizeof(ModelCacheMaterial),
+                    dependencies.data(), dependencies.size() * sizeof(ModelCacheDependency));
+
+        // Позиції нормуються до [0, 1] у межах моделі перед квантуванням
+        glm::vec3 scale = decodeScale(h.boundsMin, h.boundsMax);
+        unsigned char* vertexData = blob.data() + h.vertexOffset;
+        unsigned char* indexData = blob.data() + h.indexOffset;
+        for (MeshGeometry& geometry : geometries)
+        {
+            for (CubeVertex& vertex : geometry.vertices)
+            {
+                vertex.position = (vertex.position - h.boundsMin) / scale;
+            }
+            std::vector<unsigned char> packed = ModelLayout::pack(geometry.vertices);
+            std::memcpy(vertexData, packed.data(), packed.size());
+            vertexData += packed.size();
+
+            for (unsigned int index : geometry.indices)
+            {
+                if (h.indexType == GL_UNSIGNED_SHORT)
+                    VertexPacking::write(indexData, static_cast<uint16_t>(index));
+                else
+                    VertexPacking::write(indexData, static_cast<uint32_t>(index));
+                indexData += indexSize(h.indexType);
+            }
+        }
+        return blob;
+    }
+
+    // Запис через тимчасовий файл: перерваний запис не лишає пошкодженого кешу
+    inline bool write(const std::string& cachePath, const std::vector<unsigned char>& blob)
+    {
+        std::string temporary = cachePath + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(reinterpret_cast<const char*>(blob.data()), blob.size()))
+            {
+                std::cout << "ERROR::MODEL::CACHE_WRITE_FAILED " << cachePath << std::endl;
+                return false;
+            }
+        }
+        if (std::rename(temporary.c_str(), cachePath.c_str()) != 0)
+        {
+            std::cout << "ERROR::MODEL::CACHE_WRITE_FAILED " << cachePath << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+// GPU-буфери всієї моделі: вершини й індекси всіх мешів одним VBO / IndexBuffer
+class ModelGeometry
+{
+    public:
+        unsigned int VAO, VBO;
+        IndexBuffer indexBuffer;
+
+        // Квантовані позиції -> простір моделі
+        glm::mat4 decode;
+
+        explicit ModelGeometry(const unsigned char* blob)
+        {
+            const ModelCacheHeader& h = ModelCache::header(blob);
+
+            glGenVertexArrays(1, &VAO);
+            glGenBuffers(1, &VBO);
+
+            glBindVertexArray(VAO);
+
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, size_t(h.vertexCount) * h.vertexStride, blob + h.vertexOffset, GL_STATIC_DRAW);
+
+            indexBuffer.upload(blob + h.indexOffset, static_cast<GLsizei>(h.indexCount), h.indexType);
+
+            ModelLayout::setup();
+
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            decode = glm::scale(glm::translate(glm::mat4(1.0f), h.boundsMin),
+                                ModelCache::decodeScale(h.boundsMin, h.boundsMax));
+        }
+
+        ~ModelGeometry()
+        {
+            glDeleteVertexArrays(1, &VAO);
+            glDeleteBuffers(1, &VBO);
+        }
+
+        ModelGeometry(const ModelGeometry&) = delete;
+        ModelGeometry& operator=(const ModelGeometry&) = delete;
+};
+
+// Один меш моделі для прямого конвеєра (RenderQueue, DepthPrepass).
+// Пакетним рендерерам геометрія не віддається: вершини вже квантовані для ModelLayout
+class ModelMesh : public Mesh
+{
+    public:
+        std::shared_ptr<ModelGeometry> sharedGeometry;
+        Shader& shader;
+        std::vector<Texture*> textures;
+        // Текстури з TextureCache спільні для всіх користувачів - параметри вибірки задає меш
+        GLuint sampler;
+        Material material;
+        bool showTex = true;
+
+        ModelMesh(std::shared_ptr<ModelGeometry> geometry, const ModelCacheMesh& range, Shader& shaderRef,
+                  const Material& mat, const std::vector<Texture*>& texs, GLuint sampler)
+        : sharedGeometry(std::move(geometry)), shader(shaderRef), textures(texs), sampler(sampler), material(mat),
+          range(range)
+        {
+            uniforms = CubeUniforms(shader, textures.size());
+            setTransform(glm::mat4(1.0f));
+        }
+
+        void setTransform(const glm::mat4& matrix)
+        {
+            transform = matrix;
+            computeNormalMatrices(&transform, 1, &normalMatrix);
+        }
+
+        // Програма для проходу з іншим варіантом шейдера (RenderContext::variant).
+        // Входи вершин мають збігатися з основною програмою - VAO спільний
+        void setVariant(ShaderVariant variantId, Shader& variantShader)
+        {
+            variants[static_cast<int>(variantId)] = {&variantShader, CubeUniforms(variantShader, textures.size()),
+                                                     validateVertexInput<ModelLayout>(variantShader, "MODEL")};
+        }
+
+        void draw(RenderContext& context) override
+        {
+            GLStateCache& state = context.state;
+            ProgramVariant& variant = variants[static_cast<int>(context.variant)];
+            Shader& program = variant.shader ? *variant.shader : shader;
+            CubeUniforms& programUniforms = variant.shader ? variant.uniforms : uniforms;
+            // Основну програму перевіряє Model; варіант, що не читає ModelLayout, не малює
+            if (variant.shader && !variant.inputValid)
+                return;
+
+            state.useProgram(program.ID);
+
+            if (state.firstUseThisFrame(program.ID))
+            {
+                programUniforms.viewPos.set(context.viewPos);
+                programUniforms.view.set(context.view);
+                programUniforms.projection.set(context.projection);
+
+                for (unsigned int i = 0; i < programUniforms.textureSamplers.size(); i++)
+                {
+                    programUniforms.textureSamplers[i].set(static_cast<int>(i));
+                }
+            }
+
+            programUniforms.model.set(vertexMatrix());
+            programUniforms.uniformScale.set(normalMatrix.uniformScale());
+            if (!normalMatrix.uniformScale())
+            {
+                programUniforms.normalMatrix.set(normalMatrix.matrix());
+            }
+
+            if (state.materialChanged(program.ID, material))
+            {
+                material.setShaderUniforms(programUniforms.material);
+            }
+
+            bool hasTextures = !textures.empty();
+            programUniforms.useTextures.set(hasTextures && showTex);
+            for (unsigned int i = 0; i < textures.size(); i++)
+            {
+                state.bindTexture(i, textures[i]->ID, GL_TEXTURE_2D, sampler);
+            }
+            programUniforms.colorAlpha.set(showTex && hasTextures ? 0.0f : 1.0f);
+
+            drawGeometry(context);
+        }
+
+        void drawGeometry(RenderContext& context) override
+        {
+            GLStateCache& state = context.state;
+            const IndexBuffer& indices = sharedGeometry->indexBuffer;
+            state.bindVertexArray(sharedGeometry->VAO);
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), indices.type,
+                                     indices.offset(range.firstIndex), range.baseVertex);
+            state.stats.drawCalls++;
+        }
+
+        glm::mat4 modelMatrix() const override
+        {
+            return transform;
+        }
+
+        glm::mat4 vertexMatrix() const override
+        {
+            return transform * sharedGeometry->decode;
+        }
+
+        Material meshMaterial() const override
+        {
+            return material;
+        }
+
+        AABB worldBounds() const override
+        {
+            AABB local = {range.boundsMin, range.boundsMax};
+            return local.transformed(transform);
+        }
+
+        unsigned int shaderID() const override
+        {
+            return shader.ID;
+        }
+
+        uint32_t textureSetHash() const override
+        {
+            uint32_t hash = 2166136261u;
+            for (const Texture* texture : textures)
+            {
+                hash = (hash ^ texture->ID) * 16777619u;
+            }
+            return hash;
+        }
+
+    private:
+        ModelCacheMesh range;
+        glm::mat4 transform;
+        GpuNormalMatrix normalMatrix;
+        CubeUniforms uniforms;
+        struct ProgramVariant
+        {
+            Shader* shader = nullptr;
+            CubeUniforms uniforms;
+            bool inputValid = false;
+        };
+        ProgramVariant variants[SHADER_VARIANT_COUNT];
+};
+
+// Модель з файлу (OBJ, FBX, glTF, ...). Перший запуск імпортує через assimp і пише
+// <path>.meshcache; наступні лише хешують вихідний файл і відображають кеш у пам'ять.
+// Текстури матеріалів - з TextureCache (декодуються у фоні, спільні з іншими моделями),
+// вибірка - через sampler (SamplerCache)
+class Model
+{
+    public:
+        std::vector<std::unique_ptr<ModelMesh>> meshes;
+
+        Model(const std::string& path, Shader& shader, TextureCache& textureCache, GLuint sampler,
+              const glm::mat4& transform = glm::mat4(1.0f))
+        {
+            MappedFile source(path);
+            if (!source.valid())
+            {
+                std::cout << "ERROR::MODEL::FILE_NOT_FOUND " << path << std::endl;
+                return;
+            }
+            uint64_t sourceHash = hashBytes(source.data, source.size);
+
+            std::string cachePath = path + ".meshcache";
+            MappedFile cache(cachePath);
+            std::vector<unsigned char> imported;
+            const unsigned char* blob = nullptr;
+
+            if (cache.valid() && ModelCache::valid(cache.data, cache.size, sourceHash))
+            {
+                blob = cache.data;
+                std::cout << "MODEL::CACHE_HIT " << cachePath << std::endl;
+            }
+            else
+            {
+                imported = ModelCache::build(path, sourceHash);
+                if (imported.empty())
+                    return;
+                ModelCache::write(cachePath, imported);
+                blob = imported.data();
+            }
+
+            if (!validateVertexInput<ModelLayout>(shader, "MODEL"))
+            {
+                std::cout << "ERROR::MODEL::INCOMPATIBLE_SHADER " << path << std::endl;
+                return;
+            }
+            geometry = std::make_shared<ModelGeometry>(blob);
+
+            // Текстури - відносно каталогу моделі; однакові шляхи кеш зводить до однієї текстури
+            std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+            const ModelCacheHeader& h = ModelCache::header(blob);
+            const ModelCacheMaterial* materials = ModelCache::materials(blob);
+            std::vector<Material> converted;
+            std::vector<std::vector<Texture*>> materialTextures;
+            for (uint32_t i = 0; i < h.materialCount; ++i)
+            {
+                const ModelCacheMaterial& source = materials[i];
+                Material material = {source.albedo, source.metallic, source.roughness, source.ao, source.alpha};
+                converted.push_back(material);
+
+                std::vector<Texture*> texs;
+                std::string name(source.diffuseTexture, strnlen(source.diffuseTexture, sizeof(source.diffuseTexture)));
+                if (!name.empty())
+                {
+                    TextureHandle texture = textureCache.acquire(directory + name);
+                    textureHandles.push_back(texture);
+                    // Фрагментний шейдер змішує texture0 і texture1 - одна текстура на обидва блоки
+                    texs = {texture.get(), texture.get()};
+                }
+                materialTextures.push_back(texs);
+            }
+
+            const ModelCacheMesh* ranges = ModelCache::meshes(blob);
+            for (uint32_t i = 0; i < h.meshCount; ++i)
+            {
+                uint32_t materialIndex = std::min(ranges[i].materialIndex, h.materialCount - 1);
+                meshes.push_back(std::make_unique<ModelMesh>(geometry, ranges[i], shader, converted[materialIndex],
+                                                             materialTextures[materialIndex], sampler));
+            }
+            setTransform(transform);
+
+            std::cout << "MODEL::LOADED " << path << ": " << h.meshCount << " meshes, " << h.vertexCount
+                      << " vertices x " << h.vertexStride << " bytes, " << h.indexCount << " indices x "
+                      << indexSize(h.indexType) << " bytes" << std::endl;
+        }
+
+        void setTransform(const glm::mat4& transform)
+        {
+            for (auto& mesh : meshes)
+            {
+                mesh->setTransform(transform);
+            }
+        }
+
+        // Варіант шейдера для всіх мешів моделі, див. ModelMesh::setVariant
+        void setVariant(ShaderVariant variantId, Shader& variantShader)
+        {
+            for (auto& mesh : meshes)
+            {
+                mesh->setVariant(variantId, variantShader);
+            }
+        }
+
+        bool loaded() const
+        {
+            return geometry != nullptr;
+        }
+
+        Model(const Model&) = delete;
+        Model& operator=(const Model&) = delete;
+
+    private:
+        std::shared_ptr<ModelGeometry> geometry;
+        // Меші беруть сирі вказівники; модель тримає текстури в кеші, доки жива сама
+        std::vector<TextureHandle> textureHandles;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// Необмежена черга без блокувань: багато виробників, один споживач (Vyukov).
+// push() - один atomic exchange, pop() лише читає; споживач ніколи не чекає на виробників.
+// Елемент, який виробник ще не дописав, просто з'явиться в наступному pop()
+template <typename T>
+class MpscQueue
+{
+    public:
+        MpscQueue()
+        {
+            Node* stub = new Node();
+            head.store(stub, std::memory_order_relaxed);
+            tail = stub;
+        }
+
+        // Будь-який потік
+        void push(T value)
+        {
+            Node* node = new Node();
+            node->value = std::move(value);
+            Node* previous = head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        // Лише потік-споживач
+        bool pop(T& value)
+        {
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            // next стає новою заглушкою, його значення забираємо
+            value = std::move(next->value);
+            delete tail;
+            tail = next;
+            return true;
+        }
+
+        ~MpscQueue()
+        {
+            T value;
+            while (pop(value))
+            {
+            }
+            delete tail;
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+    private:
+        struct Node
+        {
+            std::atomic<Node*> next{nullptr};
+            T value{};
+        };
+
+        // Виробники додають у head, споживач читає з tail - різні кеш-лінії
+        alignas(64) std::atomic<Node*> head;
+        alignas(64) Node* tail;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef NORMAL_MATRIX_H
+#define NORMAL_MATRIX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cfloat>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define NORMAL_MATRIX_SIMD 1
+#endif
+
+// Модельна матриця - лише зсув і однорідний додатний масштаб: нормаль не змінює напрямку,
+// шейдер бере aNormal як є (нормалізація все одно відбувається у фрагментному шейдері)
+const uint32_t NORMAL_UNIFORM_SCALE = 1u;
+
+// Матриця нормалей transpose(inverse(mat3(model))) у std430-розкладці:
+// struct NormalMatrix { vec3 column0; uint flags; vec3 column1; float pad0; vec3 column2; float pad1; }
+struct GpuNormalMatrix
+{
+    glm::vec3 column0;
+    uint32_t flags;
+    glm::vec3 column1;
+    float pad0;
+    glm::vec3 column2;
+    float pad1;
+
+    glm::mat3 matrix() const
+    {
+        return glm::mat3(column0, column1, column2);
+    }
+
+    bool uniformScale() const
+    {
+        return (flags & NORMAL_UNIFORM_SCALE) != 0;
+    }
+};
+
+static_assert(sizeof(GpuNormalMatrix) == 48, "GpuNormalMatrix must match the std430 layout of struct NormalMatrix");
+
+// Матриці нормалей для масиву трансформацій. Для стовпців a, b, c верхньої 3x3
+// inverse-transpose = [b x c, c x a, a x b] / det - три векторні добутки замість загального обернення.
+// Вироджена матриця (det == 0, об'єкт сплющений) ділення не має: береться [b x c, c x a, a x b]
+// як є - напрямок нормалі той самий, довжину однаково нормалізує шейдер.
+// З SSE матриці обробляються по чотири (SoA через транспонування 4x4), решта - скалярно
+inline void computeNormalMatrices(const glm::mat4* models, size_t count, GpuNormalMatrix* out)
+{
+    size_t i = 0;
+
+#ifdef NORMAL_MATRIX_SIMD
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 uniformBit = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(NORMAL_UNIFORM_SCALE)));
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const float* m0 = glm::value_ptr(models[i]);
+        const float* m1 = glm::value_ptr(models[i + 1]);
+        const float* m2 = glm::value_ptr(models[i + 2]);
+        const float* m3 = glm::value_ptr(models[i + 3]);
+
+        // Після транспонування: x, y, z стовпця для чотирьох матриць (w - зсув, не потрібен)
+        __m128 ax = _mm_loadu_ps(m0), ay = _mm_loadu_ps(m1), az = _mm_loadu_ps(m2), aw = _mm_loadu_ps(m3);
+        _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+        __m128 bx = _mm_loadu_ps(m0 + 4), by = _mm_loadu_ps(m1 + 4), bz = _mm_loadu_ps(m2 + 4), bw = _mm_loadu_ps(m3 + 4);
+        _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+        __m128 cx = _mm_loadu_ps(m0 + 8), cy = _mm_loadu_ps(m1 + 8), cz = _mm_loadu_ps(m2 + 8), cw = _mm_loadu_ps(m3 + 8);
+        _MM_TRANSPOSE4_PS(cx, cy, cz, cw);
+
+        // b x c, c x a, a x b
+        __m128 n0x = _mm_sub_ps(_mm_mul_ps(by, cz), _mm_mul_ps(bz, cy));
+        __m128 n0y = _mm_sub_ps(_mm_mul_ps(bz, cx), _mm_mul_ps(bx, cz));
+        __m128 n0z = _mm_sub_ps(_mm_mul_ps(bx, cy), _mm_mul_ps(by, cx));
+        __m128 n1x = _mm_sub_ps(_mm_mul_ps(cy, az), _mm_mul_ps(cz, ay));
+        __m128 n1y = _mm_sub_ps(_mm_mul_ps(cz, ax), _mm_mul_ps(cx, az));
+        __m128 n1z = _mm_sub_ps(_mm_mul_ps(cx, ay), _mm_mul_ps(cy, ax));
+        __m128 n2x = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+        __m128 n2y = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+        __m128 n2z = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, n0x), _mm_mul_ps(ay, n0y)), _mm_mul_ps(az, n0z));
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 singular = _mm_cmplt_ps(_mm_and_ps(det, absMask), _mm_set1_ps(FLT_MIN));
+        __m128 invDet = _mm_or_ps(_mm_and_ps(singular, one), _mm_andnot_ps(singular, _mm_div_ps(one, det)));
+
+        n0x = _mm_mul_ps(n0x, invDet); n0y = _mm_mul_ps(n0y, invDet); n0z = _mm_mul_ps(n0z, invDet);
+        n1x = _mm_mul_ps(n1x, invDet); n1y = _mm_mul_ps(n1y, invDet); n1z = _mm_mul_ps(n1z, invDet);
+        n2x = _mm_mul_ps(n2x, invDet); n2y = _mm_mul_ps(n2y, invDet); n2z = _mm_mul_ps(n2z, invDet);
+
+        // Діагональна 3x3 з однаковими додатними елементами: поза діагоналлю нулі, ax == by == cz > 0
+        // (від'ємний масштаб вивертає нормалі - потрібна повна матриця)
+        __m128 offDiagonal = _mm_and_ps(_mm_and_ps(_mm_cmpeq_ps(ay, zero), _mm_cmpeq_ps(az, zero)),
+                                        _mm_and_ps(_mm_cmpeq_ps(bx, zero), _mm_cmpeq_ps(bz, zero)));
+        offDiagonal = _mm_and_ps(offDiagonal, _mm_and_ps(_mm_cmpeq_ps(cx, zero), _mm_cmpeq_ps(cy, zero)));
+        __m128 uniform = _mm_and_ps(offDiagonal, _mm_and_ps(_mm_cmpeq_ps(ax, by), _mm_cmpeq_ps(ax, cz)));
+        uniform = _mm_and_ps(uniform, _mm_cmpgt_ps(ax, zero));
+        __m128 flags = _mm_and_ps(uniform, uniformBit);
+
+        // Назад в AoS: кожен рядок - стовпець матриці нормалей однієї трансформації
+        __m128 pad0 = zero, pad1 = zero;
+        _MM_TRANSPOSE4_PS(n0x, n0y, n0z, flags);
+        _MM_TRANSPOSE4_PS(n1x, n1y, n1z, pad0);
+        _MM_TRANSPOSE4_PS(n2x, n2y, n2z, pad1);
+
+        const __m128 column0[4] = {n0x, n0y, n0z, flags};
+        const __m128 column1[4] = {n1x, n1y, n1z, pad0};
+        const __m128 column2[4] = {n2x, n2y, n2z, pad1};
+        for (int j = 0; j < 4; ++j)
+        {
+            float* dst = reinterpret_cast<float*>(&out[i + j]);
+            _mm_storeu_ps(dst, column0[j]);
+            _mm_storeu_ps(dst + 4, column1[j]);
+            _mm_storeu_ps(dst + 8, column2[j]);
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        glm::vec3 a = glm::vec3(models[i][0]);
+        glm::vec3 b = glm::vec3(models[i][1]);
+        glm::vec3 c = glm::vec3(models[i][2]);
+
+        glm::vec3 bc = glm::cross(b, c);
+        float det = glm::dot(a, bc);
+        float invDet = std::fabs(det) < FLT_MIN ? 1.0f : 1.0f / det;
+
+        GpuNormalMatrix& normal = out[i];
+        normal.column0 = bc * invDet;
+        normal.column1 = glm::cross(c, a) * invDet;
+        normal.column2 = glm::cross(a, b) * invDet;
+        normal.pad0 = normal.pad1 = 0.0f;
+
+        bool uniform = a.y == 0.0f && a.z == 0.0f && b.x == 0.0f && b.z == 0.0f &&
+                       c.x == 0.0f && c.y == 0.0f && a.x == b.y && a.x == c.z && a.x > 0.0f;
+        normal.flags = uniform ? NORMAL_UNIFORM_SCALE : 0u;
+    }
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef OIT_PASS_H
+#define OIT_PASS_H
+
+#include <glad/glad.h>
+#include <iostream>
+
+#include "shader.h"
+#include "render_state.h"
+
+// Weighted blended OIT (McGuire & Bavoil, 2013).
+// Прозорі об'єкти малюються без сортування в дві цілі: accumulation (RGBA16F, сума
+// зважених кольорів) і revealage (R8, добуток (1 - alpha)); повноекранний прохід змішує
+// середній колір з уже намальованою непрозорою сценою. Шейдер прозорих - варіант з define OIT,
+// зареєстрований в об'єктів як ShaderVariant::OIT: між begin() і resolve() вони малюються ним
+class WeightedBlendedOIT
+{
+    public:
+        unsigned int FBO, accumTexture, revealTexture, depthRBO, emptyVAO;
+        Shader& compositeShader;
+
+        WeightedBlendedOIT(Shader& compositeRef, int width, int height)
+        : compositeShader(compositeRef)
+        {
+            accumSampler = compositeShader.uniform<int>("accumTexture");
+            revealSampler = compositeShader.uniform<int>("revealTexture");
+
+            glGenFramebuffers(1, &FBO);
+            glGenTextures(1, &accumTexture);
+            glGenTextures(1, &revealTexture);
+            glGenRenderbuffers(1, &depthRBO);
+
+            // Повноекранний трикутник будується з gl_VertexID, атрибути не потрібні
+            glGenVertexArrays(1, &emptyVAO);
+
+            resize(width, height);
+        }
+
+        // Перестворення цілей під новий розмір кадру (нічого не робить, якщо розмір той самий).
+        // Прив'язує текстури напряму, тому викликається до GLStateCache::beginFrame()
+        void resize(int newWidth, int newHeight)
+        {
+            if (newWidth == width && newHeight == height)
+                return;
+            if (newWidth <= 0 || newHeight <= 0)
+                return;
+
+            width = newWidth;
+            height = newHeight;
+
+            allocateTarget(accumTexture, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+            allocateTarget(revealTexture, GL_R8, GL_RED, GL_UNSIGNED_BYTE);
+
+            // Формат має збігатися з буфером глибини вікна (GLFW за замовчуванням: 24 + 8),
+            // інакше glBlitFramebuffer глибини не спрацює
+            glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumTexture, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, revealTexture, 0);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+            const GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+            glDrawBuffers(2, drawBuffers);
+
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            {
+                std::cout << "ERROR::OIT::FRAMEBUFFER_NOT_COMPLETE" << std::endl;
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+        // Викликати після непрозорого проходу: глибина сцени копіюється, щоб прозорі
+        // фрагменти за непрозорими відкидались, але сама глибина не записується
+        void begin(RenderContext& context)
+        {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+            glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+            const float clearAccum[] = {0.0f, 0.0f, 0.0f, 0.0f};
+            const float clearReveal[] = {1.0f, 1.0f, 1.0f, 1.0f};
+            glClearBufferfv(GL_COLOR, 0, clearAccum);
+            glClearBufferfv(GL_COLOR, 1, clearReveal);
+
+            // accum: сума; revealage: dst * (1 - src)
+            glDepthMask(GL_FALSE);
+            glBlendFunci(0, GL_ONE, GL_ONE);
+            glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+
+            context.variant = ShaderVariant::OIT;
+        }
+
+        // Композиція поверх сцени у вікні: колір = accum.rgb / accum.a, непрозорість = 1 - revealage
+        void resolve(RenderContext& context)
+        {
+            context.variant = ShaderVariant::DEFAULT;
+
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glDisable(GL_DEPTH_TEST);
+
+            GLStateCache& state = context.state;
+            state.useProgram(compositeShader.ID);
+            accumSampler.set(0);
+            revealSampler.set(1);
+            state.bindTexture(0, accumTexture);
+            state.bindTexture(1, revealTexture);
+            state.bindVertexArray(emptyVAO);
+
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            state.stats.drawCalls++;
+
+            glEnable(GL_DEPTH_TEST);
+            glDepthMask(GL_TRUE);
+        }
+
+        ~WeightedBlendedOIT()
+        {
+            glDeleteFramebuffers(1, &FBO);
+            glDeleteTextures(1, &accumTexture);
+            glDeleteTextures(1, &revealTexture);
+            glDeleteRenderbuffers(1, &depthRBO);
+            glDeleteVertexArrays(1, &emptyVAO);
+        }
+
+        WeightedBlendedOIT(const WeightedBlendedOIT&) = delete;
+        WeightedBlendedOIT& operator=(const WeightedBlendedOIT&) = delete;
+
+    private:
+        int width = 0;
+        int height = 0;
+        Uniform<int> accumSampler;
+        Uniform<int> revealSampler;
+
+        void allocateTarget(unsigned int texture, GLint internalFormat, GLenum format, GLenum type)
+        {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+};
+
+#endif
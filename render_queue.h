@@ -0,0 +1,203 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "material.h"
+#include "mesh.h"
+#include "render_state.h"
+
+// 64-бітний ключ сортування пакета: [pass:2][shader:8][material:12][textures:10][depth:32].
+// Групування за станом, далі за глибиною: непрозорі - спереду назад, прозорі - ззаду наперед.
+// Прозорі об'єкти, яким потрібен строгий порядок (Material::depthSorted), малює TransparentPass
+namespace SortKey
+{
+    const int PASS_SHIFT = 62;
+
+    // Невід'ємний float зберігає порядок, якщо читати його біти як uint
+    inline uint32_t depthBits(float depth)
+    {
+        if (!(depth > 0.0f))
+            return 0;
+        uint32_t bits;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        return bits;
+    }
+
+    // Стиснення 32-бітного хешу до потрібної кількості бітів
+    inline uint64_t fold(uint32_t hash, int bits)
+    {
+        uint64_t mask = (uint64_t(1) << bits) - 1;
+        return (hash ^ (hash >> bits) ^ (hash >> (2 * bits))) & mask;
+    }
+
+    inline uint64_t make(RenderPass pass, uint32_t shaderId, uint32_t materialHash,
+                         uint32_t textureHash, float depth)
+    {
+        uint64_t state = (uint64_t(shaderId & 0xFF) << 22) |
+                         (fold(materialHash, 12) << 10) |
+                         fold(textureHash, 10);
+
+        uint32_t depthKey = depthBits(depth);
+        if (pass == RenderPass::TRANSPARENT) {
+            // Дальші об'єкти - менший ключ
+            depthKey = ~depthKey;
+        }
+
+        return (uint64_t(static_cast<int>(pass) & 0x3) << PASS_SHIFT) | (state << 32) | depthKey;
+    }
+
+    // FNV-1a для значень матеріалу (колізії лише погіршують групування, але не коректність)
+    inline uint32_t hashMaterial(const Material& material)
+    {
+        const float values[] = {
+            material.albedo.x, material.albedo.y, material.albedo.z,
+            material.metallic, material.roughness, material.ao, material.alpha,
+            static_cast<float>(material.textureLayer)
+        };
+        uint32_t hash = 2166136261u;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+        for (size_t i = 0; i < sizeof(values); ++i)
+        {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+}
+
+// Один запис черги: ключ + об'єкт, що вміє намалювати себе через RenderContext
+struct DrawPacket
+{
+    uint64_t key;
+    Mesh* mesh;
+};
+
+// Черга малювання: збирає пакети за кадр, сортує radix-сортуванням за ключем
+// і подає їх через GLStateCache, який відкидає надлишкові зміни стану
+class RenderQueue
+{
+    public:
+        // Вимкнення сортування - для порівняння лічильників стану
+        bool sortingEnabled = true;
+
+        void clear()
+        {
+            packets.clear();
+        }
+
+        void push(uint64_t key, Mesh* mesh)
+        {
+            packets.push_back({key, mesh});
+        }
+
+        // Ключ будується з даних меша; глибина - відстань від камери до центру об'єкта
+        void push(Mesh& mesh, const glm::vec3& viewPos)
+        {
+            glm::vec3 center = glm::vec3(mesh.modelMatrix()[3]);
+            float depth = glm::length(center - viewPos);
+            Material material = mesh.meshMaterial();
+
+            push(SortKey::make(renderPassFor(material), mesh.shaderID(),
+                               SortKey::hashMaterial(material), mesh.textureSetHash(), depth),
+                 &mesh);
+        }
+
+        size_t size() const
+        {
+            return packets.size();
+        }
+
+        // LSD radix-сортування по байтах ключа; проходи з однаковим байтом у всіх пакетах пропускаються
+        void sort()
+        {
+            if (packets.size() < 2)
+                return;
+
+            // Без сортування лишається тільки порядок проходів (прозорі - після непрозорих)
+            if (!sortingEnabled) {
+                std::stable_partition(packets.begin(), packets.end(), [](const DrawPacket& packet) {
+                    return (packet.key >> SortKey::PASS_SHIFT) == static_cast<uint64_t>(RenderPass::OPAQUE);
+                });
+                return;
+            }
+
+            scratch.resize(packets.size());
+            std::vector<DrawPacket>* src = &packets;
+            std::vector<DrawPacket>* dst = &scratch;
+
+            for (int shift = 0; shift < 64; shift += 8)
+            {
+                size_t counts[256] = {0};
+                for (const DrawPacket& packet : *src)
+                {
+                    counts[(packet.key >> shift) & 0xFF]++;
+                }
+
+                // Усі пакети мають цей байт однаковим - порядок не зміниться
+                if (counts[(src->front().key >> shift) & 0xFF] == src->size())
+                    continue;
+
+                size_t offset = 0;
+                for (int i = 0; i < 256; ++i)
+                {
+                    size_t count = counts[i];
+                    counts[i] = offset;
+                    offset += count;
+                }
+
+                for (const DrawPacket& packet : *src)
+                {
+                    (*dst)[counts[(packet.key >> shift) & 0xFF]++] = packet;
+                }
+
+                std::swap(src, dst);
+            }
+
+            if (src != &packets)
+                packets.swap(scratch);
+        }
+
+        void submit(RenderContext& context)
+        {
+            for (const DrawPacket& packet : packets)
+            {
+                packet.mesh->draw(context);
+            }
+        }
+
+        // Лише пакети одного проходу (наприклад, непрозорі між DepthPrepass::begin і end)
+        void submit(RenderContext& context, RenderPass pass)
+        {
+            for (const DrawPacket& packet : packets)
+            {
+                if (passOf(packet) == pass)
+                    packet.mesh->draw(context);
+            }
+        }
+
+        // Меші проходу в порядку подачі (після sort() непрозорі - спереду назад)
+        void collect(RenderPass pass, std::vector<Mesh*>& out) const
+        {
+            out.clear();
+            for (const DrawPacket& packet : packets)
+            {
+                if (passOf(packet) == pass)
+                    out.push_back(packet.mesh);
+            }
+        }
+
+    private:
+        std::vector<DrawPacket> packets;
+        std::vector<DrawPacket> scratch;
+
+        static RenderPass passOf(const DrawPacket& packet)
+        {
+            return static_cast<RenderPass>(packet.key >> SortKey::PASS_SHIFT);
+        }
+};
+
+#endif
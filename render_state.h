@@ -0,0 +1,218 @@
+#ifndef RENDER_STATE_H
+#define RENDER_STATE_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "material.h"
+
+// Лічильники GL-викликів за кадр (лише ті, що справді дійшли до драйвера)
+struct RenderStats
+{
+    unsigned int programBinds = 0;
+    unsigned int textureBinds = 0;
+    unsigned int samplerBinds = 0;
+    unsigned int activeTextureCalls = 0;
+    unsigned int vertexArrayBinds = 0;
+    unsigned int materialUploads = 0;
+    unsigned int drawCalls = 0;
+
+    // Об'єкти, відкинуті відсіканням за пірамідою видимості
+    unsigned int culledObjects = 0;
+    // Час цього відсікання на процесорі (BVH або FrustumCuller, клавіша B)
+    unsigned int cullMicroseconds = 0;
+
+    // Пари (кластер, світло) після розподілу джерел за кластерами
+    unsigned int clusterLightPairs = 0;
+
+    // Тайли відкладеного освітлення, де джерел більше за DeferredRenderer::MAX_TILE_LIGHTS
+    // (зайві відкинуто), і найбільший список тайла. Із запізненням у кадр-два
+    unsigned int tileLightOverflows = 0;
+    unsigned int maxTileLights = 0;
+
+    // Зсуви інкрементального сортування прозорих об'єктів (~0 при плавному русі камери)
+    unsigned int depthSortSwaps = 0;
+
+    // Фрагменти, що пройшли тест глибини в PBR-проході непрозорих, і скільки з них
+    // зекономив глибинний прохід (GL_SAMPLES_PASSED, результати із запізненням у кадр-два)
+    unsigned int shadedFragments = 0;
+    unsigned int overdrawSaved = 0;
+
+    // Скільки запитів на зміну стану було відкинуто як надлишкові
+    unsigned int redundantSkipped = 0;
+
+    void print(std::ostream& out) const
+    {
+        out << "draws=" << drawCalls
+            << " glUseProgram=" << programBinds
+            << " glBindTexture=" << textureBinds
+            << " glBindSampler=" << samplerBinds
+            << " glActiveTexture=" << activeTextureCalls
+            << " glBindVertexArray=" << vertexArrayBinds
+            << " material uploads=" << materialUploads
+            << " skipped=" << redundantSkipped
+            << " depth sort swaps=" << depthSortSwaps
+            << " culled=" << culledObjects
+            << " cull us=" << cullMicroseconds
+            << " cluster lights=" << clusterLightPairs
+            << " tile light overflows=" << tileLightOverflows
+            << " max tile lights=" << maxTileLights
+            << " shaded fragments=" << shadedFragments
+            << " overdraw saved=" << overdrawSaved << std::endl;
+    }
+};
+
+// Тіньова копія GL-стану: виклики, що не змінюють стан, не доходять до драйвера
+class GLStateCache
+{
+    public:
+        static const int MAX_TEXTURE_UNITS = 16;
+
+        RenderStats stats;
+        unsigned int frameIndex = 0;
+
+        GLStateCache()
+        {
+            invalidate();
+        }
+
+        // Початок кадру: скидання лічильників; стан між кадрами міг змінитись поза кешем
+        void beginFrame()
+        {
+            invalidate();
+            stats = RenderStats();
+            ++frameIndex;
+        }
+
+        // Забути відомий стан (після коду, що викликає GL напряму)
+        void invalidate()
+        {
+            program = UNKNOWN;
+            activeUnit = UNKNOWN;
+            vertexArray = UNKNOWN;
+            for (int i = 0; i < MAX_TEXTURE_UNITS; ++i)
+            {
+                textures[i] = UNKNOWN;
+                samplers[i] = UNKNOWN;
+            }
+            programFrames.clear();
+            programMaterials.clear();
+        }
+
+        void useProgram(GLuint id)
+        {
+            if (program == id) {
+                stats.redundantSkipped++;
+                return;
+            }
+            glUseProgram(id);
+            program = id;
+            stats.programBinds++;
+        }
+
+        // Кеш за блоком і ID: імена текстур унікальні для всіх цілей (2D, 2D_ARRAY).
+        // Семплер прив'язується до того ж блоку; 0 - параметри вибірки самої текстури
+        void bindTexture(unsigned int unit, GLuint id, GLenum target = GL_TEXTURE_2D, GLuint sampler = 0)
+        {
+            if (unit >= MAX_TEXTURE_UNITS) {
+                glActiveTexture(GL_TEXTURE0 + unit);
+                glBindTexture(target, id);
+                glBindSampler(unit, sampler);
+                activeUnit = UNKNOWN;
+                return;
+            }
+
+            // glBindSampler адресує блок напряму, без glActiveTexture
+            if (samplers[unit] != sampler) {
+                glBindSampler(unit, sampler);
+                samplers[unit] = sampler;
+                stats.samplerBinds++;
+            }
+
+            if (textures[unit] == id) {
+                stats.redundantSkipped++;
+                return;
+            }
+
+            if (activeUnit != unit) {
+                glActiveTexture(GL_TEXTURE0 + unit);
+                activeUnit = unit;
+                stats.activeTextureCalls++;
+            }
+
+            glBindTexture(target, id);
+            textures[unit] = id;
+            stats.textureBinds++;
+        }
+
+        void bindVertexArray(GLuint id)
+        {
+            if (vertexArray == id) {
+                stats.redundantSkipped++;
+                return;
+            }
+            glBindVertexArray(id);
+            vertexArray = id;
+            stats.vertexArrayBinds++;
+        }
+
+        // true - програма вперше використовується в цьому кадрі (час встановити uniform-и кадру)
+        bool firstUseThisFrame(GLuint programId)
+        {
+            auto it = programFrames.find(programId);
+            if (it != programFrames.end() && it->second == frameIndex)
+                return false;
+            programFrames[programId] = frameIndex;
+            return true;
+        }
+
+        // true - у програмі інший матеріал і його uniform-и треба завантажити
+        bool materialChanged(GLuint programId, const Material& material)
+        {
+            auto it = programMaterials.find(programId);
+            if (it != programMaterials.end() && sameMaterial(it->second, material)) {
+                stats.redundantSkipped++;
+                return false;
+            }
+            programMaterials[programId] = material;
+            stats.materialUploads++;
+            return true;
+        }
+
+    private:
+        static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+        GLuint program;
+        GLuint activeUnit;
+        GLuint vertexArray;
+        GLuint textures[MAX_TEXTURE_UNITS];
+        GLuint samplers[MAX_TEXTURE_UNITS];
+
+        // Uniform-стан живе в об'єкті програми, тому кешується окремо для кожної
+        std::unordered_map<GLuint, unsigned int> programFrames;
+        std::unordered_map<GLuint, Material> programMaterials;
+};
+
+// Варіант шейдера, яким прохід малює об'єкти. Об'єкт із зареєстрованою програмою для варіанта
+// (setVariant) малюється нею, решта - основною. Так прохід змінює шейдер без копій об'єктів
+enum class ShaderVariant {
+    DEFAULT = 0,
+    OIT = 1         // прозорі в цілі weighted blended OIT (define OIT)
+};
+
+const int SHADER_VARIANT_COUNT = 2;
+
+// Параметри кадру, спільні для всіх викликів малювання
+struct RenderContext
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 viewPos;
+    GLStateCache& state;
+    // Встановлює прохід (WeightedBlendedOIT::begin) і повертає по завершенні
+    ShaderVariant variant = ShaderVariant::DEFAULT;
+};
+
+#endif
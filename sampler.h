@@ -0,0 +1,95 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <glad/glad.h>
+#include <map>
+#include <tuple>
+#include <algorithm>
+
+// Стан вибірки окремо від текстури: однакові параметри - один об'єкт семплера на всі текстури
+struct SamplerDesc
+{
+    GLint wrap = GL_REPEAT;
+    GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    GLint magFilter = GL_LINEAR;
+    // 1.0 - без анізотропії; більше за GL_MAX_TEXTURE_MAX_ANISOTROPY обрізається
+    float anisotropy = 1.0f;
+
+    bool operator<(const SamplerDesc& other) const
+    {
+        return std::tie(wrap, minFilter, magFilter, anisotropy) <
+               std::tie(other.wrap, other.minFilter, other.magFilter, other.anisotropy);
+    }
+
+    // Білінійна вибірка між двома найближчими міпмапами
+    static SamplerDesc trilinear(GLint wrap = GL_REPEAT)
+    {
+        return {wrap, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, 1.0f};
+    }
+
+    // Трилінійна + анізотропна: поверхні під гострим кутом (підлога, стіни вдалині) не розмиваються
+    static SamplerDesc anisotropic(float anisotropy = 16.0f, GLint wrap = GL_REPEAT)
+    {
+        return {wrap, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, anisotropy};
+    }
+
+    // Без міпмап: цілі рендерингу, службові текстури
+    static SamplerDesc linear(GLint wrap = GL_CLAMP_TO_EDGE)
+    {
+        return {wrap, GL_LINEAR, GL_LINEAR, 1.0f};
+    }
+};
+
+// Власник об'єктів семплерів (glGenSamplers), по одному на кожен набір параметрів
+class SamplerCache
+{
+    public:
+        SamplerCache() = default;
+
+        GLuint get(const SamplerDesc& desc)
+        {
+            auto found = samplers.find(desc);
+            if (found != samplers.end())
+                return found->second;
+
+            if (maxAnisotropy == 0.0f)
+            {
+                glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+                maxAnisotropy = std::max(maxAnisotropy, 1.0f);
+            }
+
+            GLuint sampler;
+            glGenSamplers(1, &sampler);
+            glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, desc.wrap);
+            glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, desc.wrap);
+            glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, desc.minFilter);
+            glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, desc.magFilter);
+            glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY,
+                                std::clamp(desc.anisotropy, 1.0f, maxAnisotropy));
+
+            samplers[desc] = sampler;
+            return sampler;
+        }
+
+        size_t samplerCount() const
+        {
+            return samplers.size();
+        }
+
+        ~SamplerCache()
+        {
+            for (const auto& entry : samplers)
+            {
+                glDeleteSamplers(1, &entry.second);
+            }
+        }
+
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator=(const SamplerCache&) = delete;
+
+    private:
+        std::map<SamplerDesc, GLuint> samplers;
+        float maxAnisotropy = 0.0f;
+};
+
+#endif
@@ -7,102 +7,88 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <typeindex>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 
-class Shader
+// Завантаження значення в uniform за вже відомою локацією
+inline void uploadUniform(GLint location, bool value)               { glUniform1i(location, (int)value); }
+inline void uploadUniform(GLint location, int value)                { glUniform1i(location, value); }
+inline void uploadUniform(GLint location, unsigned int value)       { glUniform1ui(location, value); }
+inline void uploadUniform(GLint location, float value)              { glUniform1f(location, value); }
+inline void uploadUniform(GLint location, const glm::vec2& value)   { glUniform2fv(location, 1, &value[0]); }
+inline void uploadUniform(GLint location, const glm::vec3& value)   { glUniform3fv(location, 1, &value[0]); }
+inline void uploadUniform(GLint location, const glm::vec4& value)   { glUniform4fv(location, 1, &value[0]); }
+inline void uploadUniform(GLint location, const glm::mat3& value)   { glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+inline void uploadUniform(GLint location, const glm::mat4& value)   { glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+
+// Типізований дескриптор uniform-змінної.
+// Локація розв'язується один раз (Shader::uniform), далі set() - лише виклик glUniform*
+template <typename T>
+class Uniform
 {
     public:
-        // ID - індетифікатор програми
-        unsigned int ID;
-
-        // Конструктор читає данні і виконує побудову шейдера
-        Shader(const char* vertexPath, const char* fragmentPath) 
-        {
-            // Отримання вихідного коду вершинного та фрагментного шейдерів з змінної filePath
-            std::string vertexCode;
-            std::string fragmentCode;
-            std::ifstream vShaderFile;
-            std::ifstream fShaderFile;
-            
-            // Переконуємось що об'єкти ifstream можуть кинути помилку
-            vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-            fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-            try
-            {
-                vShaderFile.open(vertexPath);
-                fShaderFile.open(fragmentPath);
-                std::stringstream vShaderStream, fShaderStream;
+        GLint location = -1;
 
-                // Читаємо вміст файлових буферів в потоки
-                vShaderStream << vShaderFile.rdbuf();
-                fShaderStream << fShaderFile.rdbuf();
+        Uniform() = default;
+        explicit Uniform(GLint loc) : location(loc) {}
 
-                // Закриваємо файли
-                vShaderFile.close();
-                fShaderFile.close();
+        bool valid() const { return location != -1; }
 
-                // Конвертуємо данні з потоку в рядкові змінні
-                vertexCode = vShaderStream.str();
-                fragmentCode = fShaderStream.str();
-            }
-            catch(std::ifstream::failure e)
-            {
-                std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
-            }
-
-            const char* vShaderCode = vertexCode.c_str();
-            const char* fShaderCode = fragmentCode.c_str();
-            
-            // ========= КОМПІЛЯЦІЯ ШЕЙДЕРІВ ==========
-            unsigned int vertex, fragment;
-            int success;
-            char infoLog[512];
+        // Програма має бути активною (shader.use())
+        void set(const T& value) const
+        {
+            if (location != -1)
+                uploadUniform(location, value);
+        }
+};
 
-            // ================ Вершинний шейдер ================
-            vertex = glCreateShader(GL_VERTEX_SHADER);
-            glShaderSource(vertex, 1, &vShaderCode, NULL);
-            glCompileShader(vertex);
+class Shader
+{
+    public:
+        // ID - індетифікатор програми
+        unsigned int ID;
 
-            glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-            if(!success)
-            {
-                glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-                std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-            }
+        // Конструктор читає данні і виконує побудову шейдера.
+        // defines - варіанти одного шейдера (#define NAME вставляється після #version).
+        // fragmentPath == nullptr - програма лише з вершинним шейдером (глибинний прохід)
+        Shader(const char* vertexPath, const char* fragmentPath,
+               const std::vector<std::string>& defines = {}) 
+        {
+            // Отримання вихідного коду вершинного та фрагментного шейдерів з файлів
+            std::string vertexCode = injectDefines(readFile(vertexPath), defines);
+            unsigned int vertex = compileStage(GL_VERTEX_SHADER, vertexCode, "VERTEX");
 
             // =========== Фрагментний шейдер ==================
-            fragment = glCreateShader(GL_FRAGMENT_SHADER);
-            glShaderSource(fragment, 1, &fShaderCode, NULL);
-            glCompileShader(fragment);
-
-            glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-            if(!success)
+            unsigned int fragment = 0;
+            if (fragmentPath)
             {
-                glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-                std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+                std::string fragmentCode = injectDefines(readFile(fragmentPath), defines);
+                fragment = compileStage(GL_FRAGMENT_SHADER, fragmentCode, "FRAGMENT");
             }
 
             // ================== Шейдерна програма =======================
+            ID = linkProgram(vertex, fragment);
 
-            ID = glCreateProgram();
-            glAttachShader(ID, vertex);
-            glAttachShader(ID, fragment);
-            glLinkProgram(ID);
+            cacheUniformLocations();
+            cacheAttributes();
+        };
 
-            glGetProgramiv(ID, GL_LINK_STATUS, &success);
-            if(!success)
-            {
-                glGetProgramInfoLog(ID, 512, NULL, infoLog);
-                std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-            }
+        // Обчислювальна програма з одного compute-шейдера (GL 4.3+)
+        static Shader compute(const char* computePath, const std::vector<std::string>& defines = {})
+        {
+            std::string computeCode = injectDefines(readFile(computePath), defines);
+            unsigned int computeShader = compileStage(GL_COMPUTE_SHADER, computeCode, "COMPUTE");
 
-            // =============== Видалення шейдерів ==================
-            glDeleteShader(vertex);
-            glDeleteShader(fragment);
-        };
+            Shader shader;
+            shader.ID = linkProgram(computeShader, 0);
+            shader.cacheUniformLocations();
+            return shader;
+        }
 
         ~Shader() {
             if (ID != 0) {
@@ -116,7 +102,9 @@ class Shader
         Shader& operator=(const Shader&) = delete;
 
         // Дозвіл переміщення
-        Shader(Shader&& other) noexcept : ID(other.ID) {
+        Shader(Shader&& other) noexcept
+        : ID(other.ID), uniformLocations(std::move(other.uniformLocations)),
+          attributeTypes(std::move(other.attributeTypes)), vertexInputChecks(std::move(other.vertexInputChecks)) {
             other.ID = 0;
         }
 
@@ -126,6 +114,9 @@ class Shader
                     glDeleteProgram(ID);
                 }
                 ID = other.ID;
+                uniformLocations = std::move(other.uniformLocations);
+                attributeTypes = std::move(other.attributeTypes);
+                vertexInputChecks = std::move(other.vertexInputChecks);
                 other.ID = 0;
             }
             return *this;
@@ -137,14 +128,57 @@ class Shader
             glUseProgram(ID);
         };
 
-        // Uniform helpers
+        // Локація з кешу, заповненого під час лінкування (-1 якщо uniform не активний)
+        GLint getUniformLocation(const std::string &name) const
+        {
+            auto it = uniformLocations.find(name);
+            return it != uniformLocations.end() ? it->second : -1;
+        }
+
+        // Усі активні атрибути: локація -> тип
+        const std::unordered_map<GLint, GLenum>& attributes() const
+        {
+            return attributeTypes;
+        }
+
+        // Тип активного атрибута (GL_FLOAT_VEC3, ...) або 0, якщо атрибут не активний
+        GLenum attributeType(GLint location) const
+        {
+            auto it = attributeTypes.find(location);
+            return it != attributeTypes.end() ? it->second : 0;
+        }
+
+        // Результат перевірки вершинного входу (validateVertexInput) для набору розкладок layouts.
+        // Зберігається до наступного лінкування; false - набір ще не перевірявся
+        bool cachedVertexInput(std::type_index layouts, bool& valid) const
+        {
+            auto it = vertexInputChecks.find(layouts);
+            if (it == vertexInputChecks.end())
+                return false;
+            valid = it->second;
+            return true;
+        }
+
+        void cacheVertexInput(std::type_index layouts, bool valid) const
+        {
+            vertexInputChecks[layouts] = valid;
+        }
+
+        // Розв'язати типізований дескриптор один раз і перевикористовувати його щокадру
+        template <typename T>
+        Uniform<T> uniform(const std::string &name) const
+        {
+            return Uniform<T>(getUniformLocation(name));
+        }
+
+        // Uniform helpers (пошук за іменем - для ініціалізації, не для циклу рендерингу)
         void setBool(const std::string &name, bool value) const
         {
-            glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+            uploadUniform(getUniformLocation(name), value);
         };
         void setInt(const std::string &name, int value) const
         {
-            GLint location = glGetUniformLocation(ID, name.c_str());
+            GLint location = getUniformLocation(name);
             if (location == -1) {
                 std::cout << "Warning: uniform '" << name << "' not found in shader " << ID << std::endl;
                 return;
@@ -153,27 +187,210 @@ class Shader
         };
         void setFloat(const std::string &name, float value) const 
         {
-            glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+            uploadUniform(getUniformLocation(name), value);
         };
-        void setVec2(const std::string &name, const glm::vec2 &value)
+        void setVec2(const std::string &name, const glm::vec2 &value) const
         {
-            glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+            uploadUniform(getUniformLocation(name), value);
         };
 
-        void setVec3(const std::string &name, const glm::vec3 &value)
+        void setVec3(const std::string &name, const glm::vec3 &value) const
         {
-            glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+            uploadUniform(getUniformLocation(name), value);
         };
 
         void setMat4(const std::string &name, const glm::mat4& value) const
         {
-            GLint location = glGetUniformLocation(ID, name.c_str());
+            GLint location = getUniformLocation(name);
             if (location == -1) {
                 std::cout << "Warning: uniform '" << name << "' not found in shader " << ID << std::endl;
                 return;
             }
             glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
         };
+
+    private:
+        Shader() : ID(0) {}
+
+        // Вміст файлу шейдера; порожній рядок, якщо файл не прочитано
+        static std::string readFile(const char* path)
+        {
+            std::ifstream file;
+            // Переконуємось що об'єкт ifstream може кинути помилку
+            file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+            try
+            {
+                file.open(path);
+                std::stringstream stream;
+                stream << file.rdbuf();
+                file.close();
+                return stream.str();
+            }
+            catch (const std::ifstream::failure&)
+            {
+                std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ " << path << std::endl;
+                return std::string();
+            }
+        }
+
+        // Компіляція однієї стадії; type - назва стадії в повідомленні про помилку
+        static unsigned int compileStage(GLenum stage, const std::string& code, const std::string& type)
+        {
+            const char* source = code.c_str();
+            unsigned int shader = glCreateShader(stage);
+            glShaderSource(shader, 1, &source, NULL);
+            glCompileShader(shader);
+            checkCompileErrors(shader, type);
+            return shader;
+        }
+
+        // Лінкування стадій у програму (second = 0 - одна стадія); стадії після цього не потрібні
+        static unsigned int linkProgram(unsigned int first, unsigned int second)
+        {
+            unsigned int program = glCreateProgram();
+            glAttachShader(program, first);
+            if (second)
+                glAttachShader(program, second);
+            glLinkProgram(program);
+            checkCompileErrors(program, "PROGRAM");
+
+            glDeleteShader(first);
+            if (second)
+                glDeleteShader(second);
+            return program;
+        }
+
+        // Журнал компіляції стадії або лінкування програми (type == "PROGRAM")
+        static void checkCompileErrors(unsigned int object, const std::string& type)
+        {
+            int success;
+            char infoLog[512];
+            if (type != "PROGRAM")
+            {
+                glGetShaderiv(object, GL_COMPILE_STATUS, &success);
+                if (!success)
+                {
+                    glGetShaderInfoLog(object, 512, NULL, infoLog);
+                    std::cout << "ERROR::SHADER::" << type << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+                }
+            }
+            else
+            {
+                glGetProgramiv(object, GL_LINK_STATUS, &success);
+                if (!success)
+                {
+                    glGetProgramInfoLog(object, 512, NULL, infoLog);
+                    std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+                }
+            }
+        }
+
+        // Вставка "#define NAME" одразу після рядка #version (він має бути першим)
+        static std::string injectDefines(const std::string& code, const std::vector<std::string>& defines)
+        {
+            if (defines.empty())
+                return code;
+
+            std::string block;
+            for (const std::string& define : defines)
+            {
+                block += "#define " + define + "\n";
+            }
+
+            size_t versionPos = code.find("#version");
+            if (versionPos == std::string::npos)
+                return block + code;
+
+            size_t lineEnd = code.find('\n', versionPos);
+            if (lineEnd == std::string::npos)
+                return code + "\n" + block;
+
+            return code.substr(0, lineEnd + 1) + block + code.substr(lineEnd + 1);
+        }
+
+        // Ім'я uniform -> локація; заповнюється один раз після лінкування
+        std::unordered_map<std::string, GLint> uniformLocations;
+
+        // Локація активного вершинного атрибута -> його тип
+        std::unordered_map<GLint, GLenum> attributeTypes;
+
+        // Набір розкладок -> чи сумісний з програмою; скидається разом з attributeTypes
+        mutable std::unordered_map<std::type_index, bool> vertexInputChecks;
+
+        // Рефлексія активних вершинних атрибутів (GL_ACTIVE_ATTRIBUTES)
+        void cacheAttributes()
+        {
+            attributeTypes.clear();
+            vertexInputChecks.clear();
+
+            GLint count = 0;
+            GLint maxLength = 0;
+            glGetProgramiv(ID, GL_ACTIVE_ATTRIBUTES, &count);
+            glGetProgramiv(ID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+            if (count <= 0 || maxLength <= 0)
+                return;
+
+            std::vector<char> nameBuffer(maxLength);
+            for (GLint i = 0; i < count; ++i)
+            {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveAttrib(ID, (GLuint)i, maxLength, &length, &size, &type, nameBuffer.data());
+
+                // Вбудовані (gl_VertexID, gl_InstanceID, ...) не мають локації
+                GLint location = glGetAttribLocation(ID, nameBuffer.data());
+                if (location != -1)
+                    attributeTypes[location] = type;
+            }
+        }
+
+        // Рефлексія активних uniform-змінних програми (GL_ACTIVE_UNIFORMS)
+        void cacheUniformLocations()
+        {
+            uniformLocations.clear();
+
+            GLint count = 0;
+            GLint maxLength = 0;
+            glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+            glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+            if (count <= 0 || maxLength <= 0)
+                return;
+
+            std::vector<char> nameBuffer(maxLength);
+            for (GLint i = 0; i < count; ++i)
+            {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(ID, (GLuint)i, maxLength, &length, &size, &type, nameBuffer.data());
+
+                std::string name(nameBuffer.data(), length);
+                GLint location = glGetUniformLocation(ID, name.c_str());
+
+                // Члени uniform-блоків не мають локації
+                if (location == -1)
+                    continue;
+
+                uniformLocations[name] = location;
+
+                // Масиви базових типів звітуються як "name[0]" з size > 1:
+                // реєструємо "name" та кожен елемент окремо
+                const std::string arraySuffix = "[0]";
+                if (name.size() > arraySuffix.size() &&
+                    name.compare(name.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0)
+                {
+                    std::string base = name.substr(0, name.size() - arraySuffix.size());
+                    uniformLocations[base] = location;
+
+                    for (GLint element = 1; element < size; ++element)
+                    {
+                        std::string elementName = base + "[" + std::to_string(element) + "]";
+                        uniformLocations[elementName] = glGetUniformLocation(ID, elementName.c_str());
+                    }
+                }
+            }
+        }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,266 @@
+#version 450 core
+
+// Tiled deferred shading (deferred.h): одна робоча група - тайл 16x16 пікселів.
+// 1. межі глибини тайла; 2. відбір джерел, сфера яких перетинає піраміду тайла;
+// 3. освітлення кожного пікселя один раз лише списком тайла
+layout(local_size_x = 16, local_size_y = 16) in;
+
+// Дзеркалить DeferredRenderer::MAX_TILE_LIGHTS; тайли з більшою кількістю рахує TileStats
+#define MAX_TILE_LIGHTS 1024
+
+// std430, дзеркалить GpuLight у light.h
+struct Light {
+    vec3 position;
+    int type;  // 0 = directional, 1 = point, 2 = spot
+    vec3 direction;
+    float constant;
+    vec3 ambient;
+    float linear;
+    vec3 diffuse;
+    float quadratic;
+    vec3 specular;
+    float cutOff;
+    float outerCutOff;
+    float radius;  // -1 для напрямленого
+    float pad1;
+    float pad2;
+};
+
+layout(std430, binding = 0) readonly buffer LightBlock {
+    int numLights;
+    vec3 ambientSum;
+    Light lights[];
+};
+
+// Переповнення списків тайлів за кадр (DeferredRenderer читає із запізненням)
+layout(std430, binding = 5) buffer TileStats {
+    uint overflowTiles;
+    uint maxTileLights;
+};
+
+layout(binding = 0) uniform sampler2D gAlbedo;
+layout(binding = 1) uniform sampler2D gNormal;
+layout(binding = 2) uniform sampler2D gTint;
+layout(binding = 3) uniform sampler2D gDepth;
+layout(rgba8, binding = 0) writeonly uniform image2D outputImage;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat4 inverseViewProjection;
+uniform vec3 viewPos;
+uniform float nearPlane;
+uniform float farPlane;
+uniform vec3 clearColor;
+
+shared uint tileMinDepth;
+shared uint tileMaxDepth;
+shared uint tileLightCount;
+shared uint tileLights[MAX_TILE_LIGHTS];
+
+const float PI = 3.14159265359;
+
+// ===== BRDF - той самий, що й у fragment_shader_1.fs =====
+float DistributionGGX(float NdotH, float roughness)
+{
+    float a = roughness * roughness;
+    float a2 = a * a;
+    float NdotH2 = NdotH * NdotH;
+    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+    denom = PI * denom * denom;
+    return a2 / max(denom, 0.0000001);
+}
+
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+    float r = (roughness + 1.0);
+    float k = (r * r) / 8.0;
+    return NdotV / max(NdotV * (1.0 - k) + k, 0.0000001);
+}
+
+float GeometrySmith(float NdotV, float NdotL, float roughness)
+{
+    return GeometrySchlickGGX(NdotL, roughness) * GeometrySchlickGGX(NdotV, roughness);
+}
+
+vec3 FresnelSchlick(float HdotV, vec3 F0)
+{
+    return F0 + (1.0 - F0) * pow(clamp(1.0 - HdotV, 0.0, 1.0), 5.0);
+}
+
+vec3 calculateLight(Light light, vec3 fragPos, vec3 N, vec3 V, vec3 F0, float viewNdotV,
+                    vec3 albedo, float metallic, float roughness)
+{
+    vec3 L;
+    float attenuation = 1.0;
+
+    if (light.type == 0) {
+        L = normalize(-light.direction);
+    }
+    else {
+        float distanceLight = length(light.position - fragPos);
+        if (distanceLight > light.radius) return vec3(0.0);
+
+        L = normalize(light.position - fragPos);
+        attenuation = 1.0 / (light.constant + light.linear * distanceLight +
+                             light.quadratic * (distanceLight * distanceLight));
+
+        if (light.type == 2) {
+            float theta = dot(L, normalize(-light.direction));
+            float epsilon = light.cutOff - light.outerCutOff;
+            attenuation *= clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+        }
+    }
+
+    if (attenuation < 0.001) return vec3(0.0);
+
+    vec3 radiance = light.diffuse * attenuation;
+    vec3 H = normalize(V + L);
+    float NdotL = max(dot(N, L), 0.0);
+    float NdotH = max(dot(N, H), 0.0);
+    float HdotV = max(dot(H, V), 0.0);
+
+    float D = DistributionGGX(NdotH, roughness);
+    float G = GeometrySmith(viewNdotV, NdotL, roughness);
+    vec3 F = FresnelSchlick(HdotV, F0);
+
+    vec3 specular = (D * G * F) / max(4.0 * viewNdotV * NdotL, 0.001);
+    vec3 kD = (vec3(1.0) - F) * (1.0 - metallic);
+    vec3 diffuse = kD * albedo / PI;
+
+    return (diffuse + specular) * radiance * NdotL;
+}
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+float linearDepth(float windowDepth)
+{
+    float ndcDepth = windowDepth * 2.0 - 1.0;
+    return 2.0 * nearPlane * farPlane / (farPlane + nearPlane - ndcDepth * (farPlane - nearPlane));
+}
+
+// Сфера джерела проти піраміди тайла у просторі камери (симетрична перспектива)
+bool lightInTile(Light light, vec2 ndcMin, vec2 ndcMax, float minDepth, float maxDepth)
+{
+    if (light.radius < 0.0)
+        return true;
+
+    vec3 c = vec3(view * vec4(light.position, 1.0));
+    float r = light.radius;
+    float depth = -c.z;
+    if (depth + r < minDepth || depth - r > maxDepth)
+        return false;
+
+    // Площини крізь камеру: всередині, якщо ndc.x > ndcMin.x, тобто P00 * x + ndcMin.x * z > 0
+    vec4 planes[4] = vec4[4](
+        vec4(projection[0][0], 0.0, ndcMin.x, 0.0),
+        vec4(-projection[0][0], 0.0, -ndcMax.x, 0.0),
+        vec4(0.0, projection[1][1], ndcMin.y, 0.0),
+        vec4(0.0, -projection[1][1], -ndcMax.y, 0.0)
+    );
+    for (int i = 0; i < 4; ++i)
+    {
+        vec3 n = normalize(planes[i].xyz);
+        if (dot(n, c) < -r)
+            return false;
+    }
+    return true;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = textureSize(gDepth, 0);
+    bool inside = pixel.x < size.x && pixel.y < size.y;
+
+    if (gl_LocalInvocationIndex == 0u) {
+        tileMinDepth = 0xFFFFFFFFu;
+        tileMaxDepth = 0u;
+        tileLightCount = 0u;
+    }
+    barrier();
+
+    // 1. Межі глибини тайла (невід'ємний float зберігає порядок як uint)
+    float windowDepth = inside ? texelFetch(gDepth, pixel, 0).r : 1.0;
+    bool background = windowDepth >= 1.0;
+    if (!background) {
+        uint depthBits = floatBitsToUint(linearDepth(windowDepth));
+        atomicMin(tileMinDepth, depthBits);
+        atomicMax(tileMaxDepth, depthBits);
+    }
+    barrier();
+
+    // 2. Відбір джерел: кожен потік перевіряє свою частину списку
+    if (tileMaxDepth != 0u) {
+        float minDepth = uintBitsToFloat(tileMinDepth);
+        float maxDepth = uintBitsToFloat(tileMaxDepth);
+        vec2 tileSize = vec2(gl_WorkGroupSize.xy) / vec2(size);
+        vec2 ndcMin = vec2(gl_WorkGroupID.xy) * tileSize * 2.0 - 1.0;
+        vec2 ndcMax = ndcMin + tileSize * 2.0;
+
+        uint threadCount = gl_WorkGroupSize.x * gl_WorkGroupSize.y;
+        for (uint i = gl_LocalInvocationIndex; i < uint(numLights); i += threadCount)
+        {
+            if (lightInTile(lights[i], ndcMin, ndcMax, minDepth, maxDepth)) {
+                uint slot = atomicAdd(tileLightCount, 1u);
+                if (slot < MAX_TILE_LIGHTS)
+                    tileLights[slot] = i;
+            }
+        }
+    }
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0u && tileLightCount > 0u) {
+        atomicMax(maxTileLights, tileLightCount);
+        if (tileLightCount > uint(MAX_TILE_LIGHTS))
+            atomicAdd(overflowTiles, 1u);
+    }
+
+    if (!inside)
+        return;
+
+    if (background) {
+        imageStore(outputImage, pixel, vec4(clearColor, 1.0));
+        return;
+    }
+
+    // 3. Освітлення пікселя
+    vec4 albedoAo = texelFetch(gAlbedo, pixel, 0);
+    vec4 normalMaterial = texelFetch(gNormal, pixel, 0);
+    vec3 tint = texelFetch(gTint, pixel, 0).rgb;
+
+    vec3 albedo = albedoAo.rgb;
+    float ao = albedoAo.a;
+    float metallic = normalMaterial.z;
+    float roughness = normalMaterial.w;
+
+    vec2 uv = (vec2(pixel) + 0.5) / vec2(size);
+    vec4 world = inverseViewProjection * vec4(uv * 2.0 - 1.0, windowDepth * 2.0 - 1.0, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+
+    vec3 N = octDecode(normalMaterial.xy);
+    vec3 V = normalize(viewPos - fragPos);
+    float NdotV = max(dot(N, V), 0.0);
+    vec3 F0 = mix(vec3(0.04), albedo, metallic);
+
+    vec3 finalColor = ambientSum * albedo * ao * 0.3;
+    uint count = min(tileLightCount, uint(MAX_TILE_LIGHTS));
+    for (uint i = 0u; i < count; ++i)
+    {
+        finalColor += calculateLight(lights[tileLights[i]], fragPos, N, V, F0, NdotV, albedo, metallic, roughness);
+    }
+
+    // Колір текстур (лінійний) - до тонмапінгу, далі ACES і гамма, як у прямому шейдері
+    finalColor *= tint;
+    vec3 x = finalColor * 0.6;
+    finalColor = (x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14);
+    finalColor = pow(finalColor, vec3(1.0 / 2.2));
+
+    imageStore(outputImage, pixel, vec4(finalColor, 1.0));
+}
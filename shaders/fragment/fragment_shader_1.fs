@@ -6,40 +6,93 @@ struct Material {
     float roughness;
     float ao;
     float alpha;
+    int textureLayer;  // шар textureArray, -1 - без текстури
 };
 
+// std430, дзеркалить GpuLight у light.h (скаляри у четвертій компоненті vec3)
 struct Light {
+    vec3 position;
     int type;  // 0 = directional, 1 = point, 2 = spot
     
-    vec3 position;
     vec3 direction;
+    float constant;
     
     vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    
-    float constant;
     float linear;
+    
+    vec3 diffuse;
     float quadratic;
     
+    vec3 specular;
     float cutOff;
+    
     float outerCutOff;
+    float radius;  // ефективний радіус дії, -1 для напрямленого
+    float pad1;
+    float pad2;
 };
 
+#ifdef OIT
+// Weighted blended OIT: цілі accumulation і revealage (oit_pass.h)
+layout(location = 0) out vec4 accum;
+layout(location = 1) out float reveal;
+#else
 out vec4 FragColor;
+#endif
 
-in vec3 ourColor;
 in vec2 TexCoord;
 in vec3 Normal;
 in vec3 FragPos;
 
+#ifdef TEXTURE_ARRAY
+// Усі текстури - шари одного масиву (texture_array.h), шар задає матеріал
+layout(binding = 0) uniform sampler2DArray textureArray;
+#else
 uniform sampler2D texture0;
 uniform sampler2D texture1;
-uniform Light lights[32];
-uniform int numLights;
+#endif
+layout(std430, binding = 0) readonly buffer LightBlock {
+    int numLights;
+    vec3 ambientSum;  // сума ambient усіх джерел
+    Light lights[];
+};
+
+// Clustered forward (light_clusters.h): списки джерел для кожного кластера піраміди видимості
+layout(std430, binding = 3) readonly buffer ClusterGrid {
+    uvec4 clusterGridSize;      // x, y, z; w - 1, якщо кластери увімкнені
+    uvec4 clusterGlobalLights;  // x - кількість джерел без радіусу на початку clusterLightIndices
+    vec4 clusterDepthParams;    // scale, bias; near, far
+    vec4 clusterTileSize;       // розмір тайла в пікселях
+    uvec2 clusterCells[];       // зсув і кількість у clusterLightIndices
+};
+layout(std430, binding = 4) readonly buffer ClusterLightIndices {
+    uint clusterLightIndices[];
+};
 uniform vec3 viewPos;
 uniform bool useTextures;
+
+#ifdef MATERIAL_BUFFER
+// Таблиця матеріалів (MaterialBuffer), індекс приходить з інстансу
+layout(std430, binding = 1) readonly buffer MaterialBlock {
+    Material materials[];
+};
+flat in int MaterialIndex;
+#define material materials[MaterialIndex]
+#else
 uniform Material material;
+#endif
+
+vec4 materialTexture()
+{
+#ifdef TEXTURE_ARRAY
+    if (material.textureLayer < 0) {
+        return vec4(1.0);
+    }
+    return texture(textureArray, vec3(TexCoord, float(material.textureLayer)));
+#else
+    return mix(texture(texture0, TexCoord), texture(texture1, TexCoord), 0.2);
+#endif
+}
 
 const float PI = 3.14159265359;
 
@@ -95,6 +148,10 @@ vec3 calculateLight(Light light, vec3 N, vec3 V, vec3 F0, float viewNdotV)
     }
     else { // POINT (1) або SPOT (2)
         float distanceLight = length(light.position - FragPos);
+
+        // За межами радіусу дії внесок непомітний - BRDF не рахуємо
+        if (distanceLight > light.radius) return vec3(0.0);
+
         L = normalize(light.position - FragPos);
         
         // Attenuation (затухання)
@@ -149,6 +206,21 @@ vec3 calculateLight(Light light, vec3 N, vec3 V, vec3 F0, float viewNdotV)
 }
 
 
+// Кластер фрагмента: тайл екрана + експоненційний зріз за глибиною
+uint clusterIndex()
+{
+    float nearPlane = clusterDepthParams.z;
+    float farPlane = clusterDepthParams.w;
+    float ndcDepth = gl_FragCoord.z * 2.0 - 1.0;
+    float viewDepth = 2.0 * nearPlane * farPlane / (farPlane + nearPlane - ndcDepth * (farPlane - nearPlane));
+
+    float slice = floor(log(viewDepth) * clusterDepthParams.x + clusterDepthParams.y);
+    uint z = uint(clamp(slice, 0.0, float(clusterGridSize.z - 1u)));
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / clusterTileSize.xy), clusterGridSize.xy - 1u);
+
+    return tile.x + clusterGridSize.x * (tile.y + clusterGridSize.y * z);
+}
+
 void main()
 {
     // Нормалізуємо вектори
@@ -160,18 +232,31 @@ void main()
     vec3 F0 = vec3(0.04);
     F0 = mix(F0, material.albedo, material.metallic);
 
-    // 1. Ініціалізація сумматорів
-    vec3 totalAmbient = vec3(0.0); 
+    // 1. Ambient від кожного джерела (не затухає), але з меншою вагою
+    vec3 totalAmbient = ambientSum * material.albedo * material.ao * 0.3;
     vec3 finalLo = vec3(0.0);
     
-    // 2. Цикл по ВСІХ джерелах світла
-    for(int i = 0; i < numLights; ++i)
+    // 2. Цикл по джерелах світла
+    if (clusterGridSize.w != 0u)
     {
-        // Ambient беремо від кожного джерела, але з меншою вагою
-        totalAmbient += lights[i].ambient * material.albedo * material.ao * 0.3;
-        
-        // Додаємо внесок кожного світла
-        finalLo += calculateLight(lights[i], N, V, F0, NdotV);
+        // Напрямлені - для всіх фрагментів, решта - лише зі списку кластера
+        for (uint i = 0u; i < clusterGlobalLights.x; ++i)
+        {
+            finalLo += calculateLight(lights[clusterLightIndices[i]], N, V, F0, NdotV);
+        }
+
+        uvec2 cell = clusterCells[clusterIndex()];
+        for (uint i = 0u; i < cell.y; ++i)
+        {
+            finalLo += calculateLight(lights[clusterLightIndices[cell.x + i]], N, V, F0, NdotV);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < numLights; ++i)
+        {
+            finalLo += calculateLight(lights[i], N, V, F0, NdotV);
+        }
     }
     
     // 3. Фінальний колір
@@ -181,6 +266,14 @@ void main()
     float fresnelFactor = pow(1.0 - NdotV, 5.0);
     float finalAlpha = mix(material.alpha, 1.0, fresnelFactor * (1.0 - material.metallic) * 0.7);
 
+    // Застосування текстур: sRGB-текстури вже повертають лінійний колір, тож множимо
+    // до тонмапінгу й гамми
+    if (useTextures) {
+        vec4 texColor = materialTexture();
+        finalColor *= texColor.rgb;
+        finalAlpha *= texColor.a;
+    }
+
     // Tone mapping (ACES)
     vec3 x = finalColor * 0.6;
     finalColor = (x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14);
@@ -188,15 +281,16 @@ void main()
     // Gamma correction
     finalColor = pow(finalColor, vec3(1.0 / 2.2));
 
-    // Застосування текстур
-    vec4 resultColor;
-    if (useTextures) {
-        vec4 texColor = mix(texture(texture0, TexCoord), 
-                           texture(texture1, TexCoord), 0.2);
-        resultColor = texColor * vec4(finalColor, finalAlpha);
-    } else {
-        resultColor = vec4(finalColor, finalAlpha);
-    }
+    vec4 resultColor = vec4(finalColor, finalAlpha);
     
+#ifdef OIT
+    // Вага за глибиною (McGuire & Bavoil, eq. 9): ближчі і щільніші фрагменти домінують
+    float a = resultColor.a;
+    float weight = clamp(pow(min(1.0, a * 10.0) + 0.01, 3.0) * 1e8 *
+                         pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+    accum = vec4(resultColor.rgb * a, a) * weight;
+    reveal = a;
+#else
     FragColor = resultColor;
+#endif
 }
\ No newline at end of file
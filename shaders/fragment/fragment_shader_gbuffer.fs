@@ -0,0 +1,74 @@
+#version 450 core
+
+// Геометричний прохід відкладеного освітлення (deferred.h): лише атрибути поверхні, без світла
+layout(location = 0) out vec4 gAlbedo;   // albedo.rgb, ao
+layout(location = 1) out vec4 gNormal;   // октаедрична нормаль (xy), metallic, roughness
+layout(location = 2) out vec4 gTint;     // колір текстур (1.0 без текстур)
+
+struct Material {
+    vec3 albedo;
+    float metallic;
+    float roughness;
+    float ao;
+    float alpha;
+    int textureLayer;  // шар textureArray, -1 - без текстури
+};
+
+in vec2 TexCoord;
+in vec3 Normal;
+in vec3 FragPos;
+
+#ifdef TEXTURE_ARRAY
+// Усі текстури - шари одного масиву (texture_array.h), шар задає матеріал
+layout(binding = 0) uniform sampler2DArray textureArray;
+#else
+uniform sampler2D texture0;
+uniform sampler2D texture1;
+#endif
+uniform bool useTextures;
+
+#ifdef MATERIAL_BUFFER
+layout(std430, binding = 1) readonly buffer MaterialBlock {
+    Material materials[];
+};
+flat in int MaterialIndex;
+#define material materials[MaterialIndex]
+#else
+uniform Material material;
+#endif
+
+vec4 materialTexture()
+{
+#ifdef TEXTURE_ARRAY
+    if (material.textureLayer < 0) {
+        return vec4(1.0);
+    }
+    return texture(textureArray, vec3(TexCoord, float(material.textureLayer)));
+#else
+    return mix(texture(texture0, TexCoord), texture(texture1, TexCoord), 0.2);
+#endif
+}
+
+// Октаедричне кодування одиничного вектора в [-1, 1]^2
+vec2 octEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.xy;
+    if (n.z < 0.0) {
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return e;
+}
+
+void main()
+{
+    gAlbedo = vec4(material.albedo, material.ao);
+    gNormal = vec4(octEncode(normalize(Normal)), material.metallic, material.roughness);
+
+    // Як у fragment_shader_1.fs: текстури множать уже освітлений колір
+    if (useTextures) {
+        gTint = vec4(materialTexture().rgb, 1.0);
+    } else {
+        gTint = vec4(1.0);
+    }
+}
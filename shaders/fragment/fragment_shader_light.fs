@@ -28,7 +28,6 @@ struct Light {
 
 out vec4 FragColor;
 
-in vec3 ourColor;
 in vec2 TexCoord;
 in vec3 Normal;
 in vec3 FragPos;
@@ -0,0 +1,29 @@
+#version 450 core
+
+// Композиція weighted blended OIT (oit_pass.h)
+out vec4 FragColor;
+
+uniform sampler2D accumTexture;
+uniform sampler2D revealTexture;
+
+void main()
+{
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+
+    float revealage = texelFetch(revealTexture, coord, 0).r;
+
+    // Піксель без прозорих фрагментів - сцена лишається як є
+    if (revealage >= 0.9999)
+        discard;
+
+    vec4 accum = texelFetch(accumTexture, coord, 0);
+
+    // Переповнення half float при дуже великих вагах
+    if (isinf(max(max(abs(accum.r), abs(accum.g)), abs(accum.b))))
+        accum.rgb = vec3(accum.a);
+
+    vec3 averageColor = accum.rgb / max(accum.a, 0.00001);
+
+    // Змішування з GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA
+    FragColor = vec4(averageColor, 1.0 - revealage);
+}
@@ -1,11 +1,29 @@
 #version 450 core
 
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
-layout (location = 2) in vec3 aNormal;
 layout (location = 3) in vec2 aTexCoord;
 
-out vec3 ourColor;
+#ifdef OCTAHEDRAL_NORMALS
+// Нормаль в октаедричному кодуванні (NormalFormat::OCTAHEDRAL у vertex_format.h)
+layout (location = 2) in vec2 aNormal;
+
+vec3 vertexNormal()
+{
+    vec3 n = vec3(aNormal, 1.0 - abs(aNormal.x) - abs(aNormal.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+#else
+layout (location = 2) in vec3 aNormal;
+
+vec3 vertexNormal()
+{
+    return aNormal;
+}
+#endif
+
 out vec3 FragPos;
 out vec2 TexCoord;
 out vec3 lightColor;
@@ -15,17 +33,24 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// Матриця нормалей рахується на CPU (normal_matrix.h); uniformScale - модель лише
+// зсуває й однорідно масштабує, тож нормаль можна брати як є
+uniform mat3 normalMatrix;
+uniform bool uniformScale;
+
+// Має збігатися з vertex_shader_depth.vs для GL_EQUAL після глибинного проходу
+invariant gl_Position;
+
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
     
-    // Передаємо колір, текстурні координати і колір світла
-    ourColor = aColor;
+    // Передаємо текстурні координати і колір світла
     TexCoord = aTexCoord;
     lightColor = vec3(1.0);
     
     // Правильна трансформація нормалей (враховує неоднорідне масштабування)
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = uniformScale ? vertexNormal() : normalMatrix * vertexNormal();
 
     gl_Position = projection * view * model * vec4(aPos, 1.0);
 }
\ No newline at end of file
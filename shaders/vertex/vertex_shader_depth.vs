@@ -0,0 +1,17 @@
+#version 450 core
+
+// Глибинний прохід (depth_prepass.h): лише позиція, фрагментного шейдера немає.
+// gl_Position рахується тим самим виразом, що й у vertex_shader_1.vs, і позначений invariant,
+// тож глибина збігається біт у біт і PBR-прохід може тестувати її через GL_EQUAL
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
@@ -0,0 +1,81 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in vec2 aTexCoord;
+
+#ifdef OCTAHEDRAL_NORMALS
+// Нормаль в октаедричному кодуванні (NormalFormat::OCTAHEDRAL у vertex_format.h)
+layout (location = 2) in vec2 aNormal;
+
+vec3 vertexNormal()
+{
+    vec3 n = vec3(aNormal, 1.0 - abs(aNormal.x) - abs(aNormal.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+#else
+layout (location = 2) in vec3 aNormal;
+
+vec3 vertexNormal()
+{
+    return aNormal;
+}
+#endif
+
+// Матриця нормалей (GpuNormalMatrix у normal_matrix.h)
+struct NormalMatrix {
+    vec3 column0;
+    uint flags;  // 1 - лише зсув і однорідний масштаб
+    vec3 column1;
+    float pad0;
+    vec3 column2;
+    float pad1;
+};
+
+// Дані виклику (GpuDrawData у indirect_renderer.h)
+struct DrawData {
+    mat4 model;
+    NormalMatrix normal;
+    uint materialIndex;
+    uint pad0;
+    uint pad1;
+    uint pad2;
+};
+
+layout(std430, binding = 2) readonly buffer DrawBlock {
+    DrawData draws[];
+};
+
+out vec3 FragPos;
+out vec2 TexCoord;
+out vec3 lightColor;
+out vec3 Normal;
+flat out int MaterialIndex;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    // baseInstance кожної команди - індекс її запису в draws[]
+    DrawData draw = draws[gl_BaseInstance];
+    mat4 model = draw.model;
+
+    FragPos = vec3(model * vec4(aPos, 1.0));
+
+    TexCoord = aTexCoord;
+    lightColor = vec3(1.0);
+    MaterialIndex = int(draw.materialIndex);
+
+    // Правильна трансформація нормалей (враховує неоднорідне масштабування)
+    NormalMatrix normal = draw.normal;
+    if ((normal.flags & 1u) != 0u) {
+        Normal = vertexNormal();
+    } else {
+        Normal = mat3(normal.column0, normal.column1, normal.column2) * vertexNormal();
+    }
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,54 @@
+#version 450 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in vec2 aTexCoord;
+
+#ifdef OCTAHEDRAL_NORMALS
+// Нормаль в октаедричному кодуванні (NormalFormat::OCTAHEDRAL у vertex_format.h)
+layout (location = 2) in vec2 aNormal;
+
+vec3 vertexNormal()
+{
+    vec3 n = vec3(aNormal, 1.0 - abs(aNormal.x) - abs(aNormal.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+#else
+layout (location = 2) in vec3 aNormal;
+
+vec3 vertexNormal()
+{
+    return aNormal;
+}
+#endif
+
+// Дані інстансу (CubeInstance у cube_batch.h)
+layout (location = 4) in vec3 iPosition;
+layout (location = 5) in vec3 iSize;
+layout (location = 6) in uint iMaterial;
+
+out vec3 FragPos;
+out vec2 TexCoord;
+out vec3 lightColor;
+out vec3 Normal;
+flat out int MaterialIndex;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    // Модельна матриця куба - масштаб + зсув, тому обходимось без mat4
+    FragPos = aPos * iSize + iPosition;
+
+    TexCoord = aTexCoord;
+    lightColor = vec3(1.0);
+    MaterialIndex = int(iMaterial);
+
+    // Для діагонального масштабу inverse-transpose = ділення на масштаб
+    Normal = vertexNormal() / iSize;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -1,11 +1,9 @@
 #version 450 core
 
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec3 aNormal;
 layout (location = 3) in vec2 aTexCoord;
 
-out vec3 ourColor;
 out vec3 FragPos;
 out vec2 TexCoord;
 out vec3 lightColor;
@@ -15,17 +13,21 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// Матриця нормалей рахується на CPU (normal_matrix.h); uniformScale - модель лише
+// зсуває й однорідно масштабує, тож нормаль можна брати як є
+uniform mat3 normalMatrix;
+uniform bool uniformScale;
+
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
 
     FragPos = vec3(model * vec4(aPos, 1.0));
     
-    // Передаємо колір, текстурні координати і колір світла
-    ourColor = aColor;
+    // Передаємо текстурні координати і колір світла
     TexCoord = aTexCoord;
     lightColor = vec3(1.0);
     
     // Правильна трансформація нормалей (враховує неоднорідне масштабування)
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = uniformScale ? aNormal : normalMatrix * aNormal;
 }
\ No newline at end of file
@@ -3,34 +3,41 @@
 
 #include <glad/glad.h>
 #include <iostream>
+#include <algorithm>
+#include <map>
 #include "stb_image.h"
+#include "texture_file.h"
 
+// S3TC - розширення, у ядрі GL його констант немає
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+// Незмінне сховище (glTexStorage2D) з повним ланцюжком міпмап. Параметри вибірки - в об'єкті
+// семплера (SamplerCache), що прив'язується разом з текстурою; sampler = 0 - трилінійна вибірка
+// параметрами самої текстури
 class Texture {
     public:
-        unsigned int ID;
+        unsigned int ID = 0;
+        GLuint sampler = 0;
+        // Оцінка зайнятої відеопам'яті з міпмапами (TextureCache)
+        size_t memoryBytes = 0;
 
-        Texture(const char* imagePath, GLint wrap = GL_REPEAT, GLint filter = GL_LINEAR)
+        explicit Texture(const char* imagePath, GLuint sampler = 0)
+        : sampler(sampler)
         {
             stbi_set_flip_vertically_on_load(true);
 
-            glGenTextures(1, &ID);
-            glBindTexture(GL_TEXTURE_2D, ID);
-
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-
             int width, height, nrChannels;
             unsigned char* data = stbi_load(imagePath, &width, &height, &nrChannels, 0);
 
             if (data) {
-                GLenum format = (nrChannels == 1) ? GL_RED :
-                                (nrChannels == 3) ? GL_RGB :
-                                (nrChannels == 4) ? GL_RGBA : GL_RGB;
-
-                glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-                glGenerateMipmap(GL_TEXTURE_2D);
+                upload(data, width, height, nrChannels);
 
                 std::cout << "Loaded texture: " << imagePath 
                         << " (" << width << "x" << height << ", " 
@@ -40,7 +47,156 @@ class Texture {
             }
 
             stbi_image_free(data);
+        }
+
+        // Текстура з уже декодованих пікселів (заглушка, результат TextureLoader)
+        Texture(const unsigned char* pixels, int width, int height, int channels, GLuint sampler = 0)
+        : sampler(sampler)
+        {
+            upload(pixels, width, height, channels);
+        }
+
+        // Заміна вмісту. Незмінне сховище іншого розміру чи формату не перевиділити, тож тоді
+        // створюється новий ID - меші читають його під час малювання, об'єкт Texture той самий.
+        // RGB / RGBA - колір у sRGB, як і зварені texcook за замовчуванням: вибірка повертає
+        // лінійні значення незалежно від того, звідки прийшла текстура
+        void upload(const unsigned char* pixels, int width, int height, int channels)
+        {
+            GLenum format = (channels == 1) ? GL_RED :
+                            (channels == 2) ? GL_RG :
+                            (channels == 4) ? GL_RGBA : GL_RGB;
+            GLenum internalFormat = (channels == 1) ? GL_R8 :
+                                    (channels == 2) ? GL_RG8 :
+                                    (channels == 4) ? GL_SRGB8_ALPHA8 : GL_SRGB8;
+
+            GLsizei levels = mipLevels(width, height);
+            if (ID == 0 || width != storageWidth || height != storageHeight || internalFormat != storageFormat ||
+                levels != storageLevels)
+                allocate(width, height, internalFormat, levels);
+
+            glBindTexture(GL_TEXTURE_2D, ID);
+            // Рядки RGB / RED не кратні 4 байтам
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, pixels);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            unbind();
+
+            // Повний ланцюжок міпмап - ще третина від базового рівня
+            memoryBytes = size_t(width) * height * channels * 4 / 3;
+        }
+
+        // Готовий .tex (tools/texcook), зазвичай відображений у пам'ять: рівні йдуть у GPU як є,
+        // без декодування й glGenerateMipmap. firstLevel - найдетальніший рівень, що стає рівнем 0
+        // текстури (TextureStreamer): дрібніші в пам'ять GPU не потрапляють.
+        // false - файл пошкоджений, іншої версії або драйвер не підтримує його формат стиснення
+        bool uploadCooked(const unsigned char* blob, size_t size, uint32_t firstLevel = 0)
+        {
+            if (!TextureFile::valid(blob, size))
+                return false;
+
+            const TextureFileHeader& header = TextureFile::header(blob);
+            const TextureFileLevel* levels = TextureFile::levels(blob);
+            GLenum internalFormat = cookedFormat(header);
+
+            // S3TC - розширення, BPTC може бути вимкнений драйвером: без підтримки сховище не створиться
+            if (TextureFile::compressed(static_cast<TextureFileFormat>(header.format)) && !formatSupported(internalFormat))
+            {
+                std::cout << "ERROR::TEXTURE::UNSUPPORTED_FORMAT 0x" << std::hex << internalFormat << std::dec << std::endl;
+                return false;
+            }
+
+            firstLevel = std::min(firstLevel, header.levelCount - 1);
+            levels += firstLevel;
+            GLsizei levelCount = static_cast<GLsizei>(header.levelCount - firstLevel);
+            int width = static_cast<int>(levels[0].width), height = static_cast<int>(levels[0].height);
+            if (ID == 0 || width != storageWidth || height != storageHeight ||
+                internalFormat != storageFormat || levelCount != storageLevels)
+                allocate(width, height, internalFormat, levelCount);
+
+            glBindTexture(GL_TEXTURE_2D, ID);
+            memoryBytes = 0;
+            for (GLsizei i = 0; i < levelCount; ++i)
+            {
+                uploadCookedLevel(header, levels[i], blob, i);
+                memoryBytes += levels[i].size;
+            }
+            unbind();
+            return true;
+        }
+
+        // Зміна рівня стрімінгу (TextureStreamer) для текстури, завантаженої uploadCooked з рівня
+        // residentLevel: нове сховище з рівня firstLevel. Рівні, що вже є в GPU, копіюються
+        // glCopyImageSubData без участі процесора, з blob читаються лише нові, детальніші
+        bool restreamCooked(const unsigned char* blob, size_t size, uint32_t firstLevel, uint32_t residentLevel)
+        {
+            if (ID == 0)
+                return uploadCooked(blob, size, firstLevel);
+            if (!TextureFile::valid(blob, size))
+                return false;
+
+            const TextureFileHeader& header = TextureFile::header(blob);
+            const TextureFileLevel* levels = TextureFile::levels(blob);
+            firstLevel = std::min(firstLevel, header.levelCount - 1);
+
+            // allocate() звільнив би стару текстуру, а з неї ще копіюємо
+            GLuint previous = ID;
+            ID = 0;
+            allocate(static_cast<int>(levels[firstLevel].width), static_cast<int>(levels[firstLevel].height),
+                     storageFormat, static_cast<GLsizei>(header.levelCount - firstLevel));
+
+            memoryBytes = 0;
+            for (uint32_t level = firstLevel; level < header.levelCount; ++level)
+            {
+                const TextureFileLevel& source = levels[level];
+                GLint target = static_cast<GLint>(level - firstLevel);
+                if (level >= residentLevel)
+                {
+                    glCopyImageSubData(previous, GL_TEXTURE_2D, static_cast<GLint>(level - residentLevel), 0, 0, 0,
+                                       ID, GL_TEXTURE_2D, target, 0, 0, 0, source.width, source.height, 1);
+                }
+                else
+                {
+                    uploadCookedLevel(header, source, blob, target);
+                }
+                memoryBytes += source.size;
+            }
             unbind();
+            glDeleteTextures(1, &previous);
+            return true;
+        }
+
+        // Пікселі з буфера GL_PIXEL_UNPACK_BUFFER (UploadRing): glTexSubImage2D лише ставить
+        // копіювання в чергу GPU, не чекаючи на нього
+        void upload(GLuint unpackBuffer, size_t offset, int width, int height, int channels)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpackBuffer);
+            upload(reinterpret_cast<const unsigned char*>(offset), width, height, channels);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
+        // Чи можна створити 2D-текстуру з таким внутрішнім форматом (GL 4.3, запит кешується)
+        static bool formatSupported(GLenum internalFormat)
+        {
+            static std::map<GLenum, bool> supported;
+            auto found = supported.find(internalFormat);
+            if (found != supported.end())
+                return found->second;
+
+            GLint result = GL_FALSE;
+            glGetInternalformativ(GL_TEXTURE_2D, internalFormat, GL_INTERNALFORMAT_SUPPORTED, 1, &result);
+            return supported[internalFormat] = result == GL_TRUE;
+        }
+
+        // Рівнів у ланцюжку до 1x1 включно
+        static GLsizei mipLevels(int width, int height)
+        {
+            GLsizei levels = 1;
+            for (int size = std::max(width, height); size > 1; size >>= 1)
+            {
+                levels++;
+            }
+            return levels;
         }
 
         void bind() const {
@@ -61,7 +217,11 @@ class Texture {
         Texture(const Texture&) = delete;
         Texture& operator=(const Texture&) = delete;
 
-        Texture(Texture&& other) noexcept : ID(other.ID) {
+        Texture(Texture&& other) noexcept
+        : ID(other.ID), sampler(other.sampler), memoryBytes(other.memoryBytes),
+          storageWidth(other.storageWidth), storageHeight(other.storageHeight), storageFormat(other.storageFormat),
+          storageLevels(other.storageLevels)
+        {
             other.ID = 0;
         }
 
@@ -71,12 +231,73 @@ class Texture {
                     glDeleteTextures(1, &ID);
                 }
                 ID = other.ID;
+                sampler = other.sampler;
+                memoryBytes = other.memoryBytes;
+                storageWidth = other.storageWidth;
+                storageHeight = other.storageHeight;
+                storageFormat = other.storageFormat;
+                storageLevels = other.storageLevels;
                 other.ID = 0;
             }
             return *this;
         }
 
+    private:
+        int storageWidth = 0;
+        int storageHeight = 0;
+        GLenum storageFormat = 0;
+        GLsizei storageLevels = 0;
 
+        static GLenum cookedFormat(const TextureFileHeader& header)
+        {
+            bool srgb = header.flags & TEXTURE_FILE_SRGB;
+            switch (static_cast<TextureFileFormat>(header.format))
+            {
+                case TextureFileFormat::BC1:
+                    return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                case TextureFileFormat::BC3:
+                    return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case TextureFileFormat::BC7:
+                    return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+                default:
+                    return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+            }
+        }
+
+        // Текстура прив'язана до GL_TEXTURE_2D, сховище вже створене
+        void uploadCookedLevel(const TextureFileHeader& header, const TextureFileLevel& level,
+                               const unsigned char* blob, GLint target)
+        {
+            if (TextureFile::compressed(static_cast<TextureFileFormat>(header.format)))
+            {
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, target, 0, 0, level.width, level.height, storageFormat,
+                                          static_cast<GLsizei>(level.size), blob + level.offset);
+            }
+            else
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, target, 0, 0, level.width, level.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                                blob + level.offset);
+            }
+        }
+
+        void allocate(int width, int height, GLenum internalFormat, GLsizei levels)
+        {
+            if (ID != 0)
+                glDeleteTextures(1, &ID);
+
+            glGenTextures(1, &ID);
+            glBindTexture(GL_TEXTURE_2D, ID);
+            glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height);
+
+            // Запасна вибірка без семплера; прив'язаний семплер її перекриває
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+            storageWidth = width;
+            storageHeight = height;
+            storageFormat = internalFormat;
+            storageLevels = levels;
+        }
 };
 
 #endif
\ No newline at end of file
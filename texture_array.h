@@ -0,0 +1,232 @@
+#ifndef TEXTURE_ARRAY_H
+#define TEXTURE_ARRAY_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include "texture_loader.h"
+#include "texture.h"
+
+// Текстурний блок масиву в шейдерах з TEXTURE_ARRAY (layout(binding = 0) sampler2DArray textureArray)
+const unsigned int TEXTURE_ARRAY_UNIT = 0;
+
+// Текстури одного розміру як шари GL_TEXTURE_2D_ARRAY. Шар обирає матеріал (Material::textureLayer),
+// тож об'єкти з різними текстурами малюються без перемикань текстур між ними - один bind на кадр
+// для інстансованих і multi-draw пакетів. Зображення іншого розміру масштабуються до розміру масиву.
+// Масштабування й міпмапи шару рахуються в робочому потоці TextureLoader; GL-потік лише
+// завантажує готові рівні одного шару, не чіпаючи решту масиву
+class TextureArray : public std::enable_shared_from_this<TextureArray>
+{
+    public:
+        unsigned int ID = 0;
+        // Об'єкт SamplerCache; 0 - трилінійна вибірка параметрами самого масиву
+        GLuint sampler;
+        const int width;
+        const int height;
+        const int capacity;
+        // Усі шари з міпмапами, RGBA8 у sRGB (як Texture)
+        size_t memoryBytes;
+
+        TextureArray(int width, int height, int capacity, GLuint sampler = 0)
+        : sampler(sampler), width(width), height(height), capacity(capacity),
+          memoryBytes(size_t(width) * height * 4 * capacity * 4 / 3), levels(Texture::mipLevels(width, height))
+        {
+            glGenTextures(1, &ID);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+            // Незмінне сховище: усі шари й рівні міпмап виділені одразу
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, GL_SRGB8_ALPHA8, width, height, capacity);
+
+            glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        }
+
+        // Шар для зображення з файлу; повторний шлях - той самий шар, -1 - масив заповнено.
+        // До завершення декодування шар сірий. Масив має належати std::shared_ptr
+        int load(const std::string& path, TextureLoader& loader)
+        {
+            std::string key = canonicalTexturePath(path);
+            auto found = layers.find(key);
+            if (found != layers.end())
+                return found->second;
+
+            if (count >= capacity)
+            {
+                std::cout << "ERROR::TEXTURE_ARRAY::FULL " << path << std::endl;
+                return -1;
+            }
+
+            int layer = count++;
+            layers[key] = layer;
+
+            // Заливка на GPU, без CPU-копії ланцюжка
+            static const unsigned char placeholder[4] = {128, 128, 128, 255};
+            for (int level = 0; level < levels; ++level)
+            {
+                glClearTexSubImage(ID, level, 0, 0, layer, levelSize(width, level), levelSize(height, level), 1,
+                                   GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+            }
+
+            std::weak_ptr<TextureArray> self = weak_from_this();
+            int arrayWidth = width, arrayHeight = height;
+            loader.load(key,
+                [self, layer](const unsigned char* chain, int, int, int) {
+                    std::shared_ptr<TextureArray> array = self.lock();
+                    if (!array)
+                        return false;
+                    array->uploadChain(layer, chain);
+                    return true;
+                },
+                [arrayWidth, arrayHeight](const unsigned char* pixels, int& w, int& h, int& channels) {
+                    std::vector<unsigned char> chain = buildChain(pixels, w, h, channels, arrayWidth, arrayHeight);
+                    w = arrayWidth;
+                    h = arrayHeight;
+                    channels = 4;
+                    return chain;
+                });
+            return layer;
+        }
+
+        // Заміна вмісту шару зображенням з пам'яті (GL-потік; масштабування й міпмапи - тут же)
+        void upload(int layer, const unsigned char* pixels, int w, int h, int channels)
+        {
+            uploadChain(layer, buildChain(pixels, w, h, channels, width, height).data());
+        }
+
+        // Готовий ланцюжок рівнів шару (buildChain): лише цей шар, без glGenerateMipmap по масиву
+        void uploadChain(int layer, const unsigned char* chain)
+        {
+            glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+            for (int level = 0; level < levels; ++level)
+            {
+                int w = levelSize(width, level), h = levelSize(height, level);
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, w, h, 1, GL_RGBA, GL_UNSIGNED_BYTE, chain);
+                chain += size_t(w) * h * 4;
+            }
+            glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        }
+
+        int layerCount() const
+        {
+            return count;
+        }
+
+        ~TextureArray()
+        {
+            if (ID != 0)
+                glDeleteTextures(1, &ID);
+        }
+
+        TextureArray(const TextureArray&) = delete;
+        TextureArray& operator=(const TextureArray&) = delete;
+
+    private:
+        const int levels;
+        std::map<std::string, int> layers;
+        int count = 0;
+
+        static int levelSize(int size, int level)
+        {
+            return std::max(1, size >> level);
+        }
+
+        // Будь-яке зображення -> ланцюжок RGBA8 від width x height до 1x1, рівні підряд.
+        // Будь-який потік
+        static std::vector<unsigned char> buildChain(const unsigned char* pixels, int w, int h, int channels,
+                                                     int width, int height)
+        {
+            std::vector<unsigned char> chain = resample(pixels, w, h, channels, width, height);
+            size_t levelOffset = 0;
+            for (int level = 1; level < Texture::mipLevels(width, height); ++level)
+            {
+                int sourceWidth = levelSize(width, level - 1), sourceHeight = levelSize(height, level - 1);
+                size_t next = levelOffset + size_t(sourceWidth) * sourceHeight * 4;
+                downsample(chain, levelOffset, sourceWidth, sourceHeight);
+                levelOffset = next;
+            }
+            return chain;
+        }
+
+        // Рівень у кінець chain: середнє 2x2 з рівня за offset, усереднення в лінійному просторі
+        static void downsample(std::vector<unsigned char>& chain, size_t offset, int w, int h)
+        {
+            static const std::vector<float> toLinear = []() {
+                std::vector<float> table(256);
+                for (int i = 0; i < 256; ++i)
+                {
+                    float c = i / 255.0f;
+                    table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return table;
+            }();
+            auto toSrgb = [](float c) {
+                c = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                return static_cast<unsigned char>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+            };
+
+            int nw = std::max(1, w / 2), nh = std::max(1, h / 2);
+            chain.resize(chain.size() + size_t(nw) * nh * 4);
+            const unsigned char* source = chain.data() + offset;
+            unsigned char* target = chain.data() + offset + size_t(w) * h * 4;
+            for (int y = 0; y < nh; ++y)
+            {
+                int y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+                for (int x = 0; x < nw; ++x)
+                {
+                    int x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+                    const unsigned char* p[4] = {source + (size_t(y0) * w + x0) * 4, source + (size_t(y0) * w + x1) * 4,
+                                                 source + (size_t(y1) * w + x0) * 4, source + (size_t(y1) * w + x1) * 4};
+                    unsigned char* out = target + (size_t(y) * nw + x) * 4;
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        out[c] = toSrgb((toLinear[p[0][c]] + toLinear[p[1][c]] + toLinear[p[2][c]] + toLinear[p[3][c]]) * 0.25f);
+                    }
+                    out[3] = static_cast<unsigned char>((p[0][3] + p[1][3] + p[2][3] + p[3][3] + 2) / 4);
+                }
+            }
+        }
+
+        // Будь-яке зображення -> RGBA8 розміру width x height (білінійно)
+        static std::vector<unsigned char> resample(const unsigned char* pixels, int w, int h, int channels,
+                                                   int width, int height)
+        {
+            auto texel = [&](int x, int y, int c) -> float {
+                const unsigned char* p = pixels + (size_t(y) * w + x) * channels;
+                if (channels >= 3)
+                    return c < 3 ? p[c] : (channels == 4 ? p[3] : 255.0f);
+                // Сірі (1) і сірі з альфою (2)
+                return c < 3 ? p[0] : (channels == 2 ? p[1] : 255.0f);
+            };
+
+            std::vector<unsigned char> rgba(size_t(width) * height * 4);
+            for (int y = 0; y < height; ++y)
+            {
+                float sy = std::max(0.0f, (y + 0.5f) * h / height - 0.5f);
+                int y0 = std::min(int(sy), h - 1), y1 = std::min(y0 + 1, h - 1);
+                float fy = sy - y0;
+                for (int x = 0; x < width; ++x)
+                {
+                    float sx = std::max(0.0f, (x + 0.5f) * w / width - 0.5f);
+                    int x0 = std::min(int(sx), w - 1), x1 = std::min(x0 + 1, w - 1);
+                    float fx = sx - x0;
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        float top = texel(x0, y0, c) * (1.0f - fx) + texel(x1, y0, c) * fx;
+                        float bottom = texel(x0, y1, c) * (1.0f - fx) + texel(x1, y1, c) * fx;
+                        rgba[(size_t(y) * width + x) * 4 + c] =
+                            static_cast<unsigned char>(std::lround(top * (1.0f - fy) + bottom * fy));
+                    }
+                }
+            }
+            return rgba;
+        }
+};
+
+#endif
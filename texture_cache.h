@@ -0,0 +1,154 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "texture.h"
+#include "texture_loader.h"
+#include "texture_file.h"
+#include "mapped_file.h"
+#include "texture_streamer.h"
+
+// Спільна текстура: поки живий хоч один дескриптор, кеш її не звільнить
+using TextureHandle = std::shared_ptr<Texture>;
+
+// Коли звільняти текстури, на які більше ніхто не посилається
+enum class TextureEviction {
+    LAST_REFERENCE,     // одразу в collect()
+    LRU                 // лише коли сумарний обсяг перевищує бюджет, найдавніше використані першими
+};
+
+// Кеш текстур за канонічним шляхом: одне зображення з тисяч об'єктів декодується й
+// завантажується один раз, хоч би з якими параметрами вибірки його читали. Власник текстур -
+// кеш; меші тримають TextureHandle. Семплер (SamplerCache) обирає той, хто прив'язує текстуру
+class TextureCache
+{
+    public:
+        TextureEviction eviction;
+        // Бюджет відеопам'яті для TextureEviction::LRU
+        size_t budgetBytes;
+        // Зварені текстури - з грубого рівня, детальніші рівні на вимогу; nullptr - одразу всі рівні
+        TextureStreamer* streamer = nullptr;
+
+        explicit TextureCache(TextureLoader& loader, TextureEviction eviction = TextureEviction::LRU,
+                              size_t budgetBytes = size_t(512) << 20)
+        : eviction(eviction), budgetBytes(budgetBytes), loader(loader)
+        {}
+
+        TextureHandle acquire(const std::string& path)
+        {
+            std::string key = canonicalTexturePath(path);
+            Entry& entry = entries[key];
+            entry.lastUsedFrame = frame;
+            if (entry.texture)
+                return entry.texture;
+
+            // Заглушка 1x1, доки TextureLoader не декодує зображення
+            static const unsigned char placeholder[4] = {128, 128, 128, 255};
+            entry.texture = std::make_shared<Texture>(placeholder, 1, 1, 4);
+
+            // Зварений texcook .tex поруч із зображенням - одразу, без декодування, якщо зварений
+            // з поточного вмісту зображення
+            std::string cookedPath = TextureFile::cookedPath(key);
+            MappedFile cooked(cookedPath);
+            if (cooked.valid())
+            {
+                if (!TextureFile::valid(cooked.data, cooked.size) || !cookedMatchesSource(key, cooked))
+                    std::cout << "TEXTURE_CACHE::STALE_COOKED_TEXTURE " << cookedPath << std::endl;
+                else if (streamer ? streamer->add(entry.texture, cookedPath)
+                                  : entry.texture->uploadCooked(cooked.data, cooked.size))
+                    return entry.texture;
+                else
+                    std::cout << "ERROR::TEXTURE_CACHE::INVALID_COOKED_TEXTURE " << cookedPath << std::endl;
+            }
+
+            loader.load(key, entry.texture);
+            return entry.texture;
+        }
+
+        // Раз на кадр: позначити використані текстури і звільнити непотрібні згідно з eviction
+        void collect()
+        {
+            frame++;
+
+            std::vector<std::map<std::string, Entry>::iterator> unused;
+            size_t total = 0;
+            for (auto it = entries.begin(); it != entries.end(); ++it)
+            {
+                total += it->second.texture->memoryBytes;
+                if (it->second.texture.use_count() > 1)
+                    it->second.lastUsedFrame = frame;
+                else
+                    unused.push_back(it);
+            }
+
+            if (eviction == TextureEviction::LRU)
+            {
+                std::sort(unused.begin(), unused.end(), [](const auto& a, const auto& b) {
+                    return a->second.lastUsedFrame < b->second.lastUsedFrame;
+                });
+            }
+
+            for (auto it : unused)
+            {
+                if (eviction == TextureEviction::LRU && total <= budgetBytes)
+                    break;
+                total -= it->second.texture->memoryBytes;
+                entries.erase(it);
+            }
+            residentBytes = total;
+        }
+
+        size_t textureCount() const
+        {
+            return entries.size();
+        }
+
+        // Станом на останній collect()
+        size_t memoryBytes() const
+        {
+            return residentBytes;
+        }
+
+        void print(std::ostream& out) const
+        {
+            out << "TEXTURE_CACHE: " << entries.size() << " textures, " << (residentBytes >> 10) << " KiB" << std::endl;
+            for (const auto& entry : entries)
+            {
+                out << "  " << entry.first << " - " << (entry.second.texture->memoryBytes >> 10) << " KiB, "
+                    << entry.second.texture.use_count() - 1 << " refs" << std::endl;
+            }
+        }
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+    private:
+        struct Entry
+        {
+            TextureHandle texture;
+            uint64_t lastUsedFrame = 0;
+        };
+
+        // Хеш вихідного зображення збігається з записаним texcook. Без вихідного файлу
+        // (у збірці лише .tex) зварений вважається актуальним
+        static bool cookedMatchesSource(const std::string& path, const MappedFile& cooked)
+        {
+            MappedFile source(path);
+            if (!source.valid())
+                return true;
+            return TextureFile::matchesSource(cooked.data, hashBytes(source.data, source.size));
+        }
+
+        TextureLoader& loader;
+        std::map<std::string, Entry> entries;
+        uint64_t frame = 0;
+        size_t residentBytes = 0;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef TEXTURE_FILE_H
+#define TEXTURE_FILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Готова до завантаження текстура (<зображення з розширенням>.tex), пише tools/texcook:
+//   TextureFileHeader | TextureFileLevel[levelCount] | рівні міпмап від найбільшого
+// Кожен рівень уже у форматі GPU (RGBA8 або блоки BC), тож файл відображається в пам'ять
+// і передається в glCompressedTexSubImage2D без декодування й glGenerateMipmap.
+// sourceHash - hashBytes вихідного зображення: змінене зображення робить .tex застарілим
+const uint32_t TEXTURE_FILE_MAGIC = 0x58455445;    // "ETEX"
+const uint32_t TEXTURE_FILE_VERSION = 2;
+// Початок кожного рівня вирівняний на 16 байт
+const uint64_t TEXTURE_FILE_ALIGNMENT = 16;
+
+enum class TextureFileFormat : uint32_t {
+    RGBA8 = 0,
+    BC1 = 1,        // RGB, 4 біти на піксель
+    BC3 = 2,        // RGBA, 8 біт на піксель
+    BC7 = 3         // RGBA, 8 біт на піксель, якість близька до RGBA8
+};
+
+// Кольорові дані в sRGB: на GPU - sRGB-формат, вибірка повертає лінійні значення
+const uint32_t TEXTURE_FILE_SRGB = 1u << 0;
+
+struct TextureFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;        // TextureFileFormat
+    uint32_t flags;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint32_t reserved;
+    uint64_t sourceHash;
+};
+
+struct TextureFileLevel
+{
+    uint64_t offset;        // від початку файлу
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+static_assert(sizeof(TextureFileHeader) == 40, "TextureFileHeader layout is part of the file format");
+static_assert(sizeof(TextureFileLevel) == 24, "TextureFileLevel layout is part of the file format");
+
+namespace TextureFile
+{
+    inline bool compressed(TextureFileFormat format)
+    {
+        return format != TextureFileFormat::RGBA8;
+    }
+
+    // Розмір рівня в байтах; блоки BC - 4x4 пікселі, неповні по краях теж займають цілий блок
+    inline uint64_t levelBytes(TextureFileFormat format, uint32_t width, uint32_t height)
+    {
+        if (!compressed(format))
+            return uint64_t(width) * height * 4;
+
+        uint64_t blocks = uint64_t((width + 3) / 4) * ((height + 3) / 4);
+        return blocks * (format == TextureFileFormat::BC1 ? 8 : 16);
+    }
+
+    inline const TextureFileHeader& header(const unsigned char* blob)
+    {
+        return *reinterpret_cast<const TextureFileHeader*>(blob);
+    }
+
+    inline const TextureFileLevel* levels(const unsigned char* blob)
+    {
+        return reinterpret_cast<const TextureFileLevel*>(blob + sizeof(TextureFileHeader));
+    }
+
+    // Файл придатний, якщо це ця версія формату, розміри рівнів - ланцюжок половинних
+    // розмірів і всі рівні лежать у межах файлу
+    inline bool valid(const unsigned char* blob, size_t size)
+    {
+        if (size < sizeof(TextureFileHeader))
+            return false;
+
+        const TextureFileHeader& h = header(blob);
+        if (h.magic != TEXTURE_FILE_MAGIC || h.version != TEXTURE_FILE_VERSION)
+            return false;
+        if (h.format > uint32_t(TextureFileFormat::BC7) || h.width == 0 || h.height == 0 ||
+            h.levelCount == 0 || h.levelCount > 32)
+            return false;
+        if (sizeof(TextureFileHeader) + uint64_t(h.levelCount) * sizeof(TextureFileLevel) > size)
+            return false;
+
+        TextureFileFormat format = static_cast<TextureFileFormat>(h.format);
+        uint32_t width = h.width, height = h.height;
+        const TextureFileLevel* l = levels(blob);
+        for (uint32_t i = 0; i < h.levelCount; ++i)
+        {
+            if (l[i].width != width || l[i].height != height ||
+                l[i].size != levelBytes(format, width, height) || l[i].offset + l[i].size > size)
+                return false;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        return true;
+    }
+
+    // Зварений з того самого вмісту, що й вихідне зображення зараз
+    inline bool matchesSource(const unsigned char* blob, uint64_t sourceHash)
+    {
+        return header(blob).sourceHash == sourceHash;
+    }
+
+    // "res/a.png" -> "res/a.png.tex": a.png і a.jpg поруч не ділять один .tex
+    inline std::string cookedPath(const std::string& path)
+    {
+        return path + ".tex";
+    }
+}
+
+#endif
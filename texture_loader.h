@@ -0,0 +1,246 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <string>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <filesystem>
+#include <cstring>
+#include <vector>
+#include "stb_image.h"
+#include "texture.h"
+#include "thread_pool.h"
+#include "mpsc_queue.h"
+#include "upload_ring.h"
+
+// "./res/a.png" і "res/../res/a.png" - один ключ; неіснуючий файл лишається як є,
+// помилку покаже TextureLoader
+inline std::string canonicalTexturePath(const std::string& path)
+{
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    return error ? path : canonical.string();
+}
+
+// Отримувач декодованого зображення, викликається в GL-потоці.
+// false - ціль уже звільнена, нічого не завантажено
+using TextureUpload = std::function<bool(const unsigned char* pixels, int width, int height, int channels)>;
+
+// Обробка декодованого зображення в робочому потоці (масштабування, міпмапи). Повертає байти,
+// які отримає TextureUpload; width / height / channels можна змінити під результат
+using TexturePrepare = std::function<std::vector<unsigned char>(const unsigned char* pixels,
+                                                                int& width, int& height, int& channels)>;
+
+// Асинхронне завантаження текстур: stbi_load на пулі потоків, завантаження в GPU - у GL-потоці
+// в межах бюджету часу на кадр. Вміст цільової текстури замінюється на місці;
+// текстуру, звільнену до кінця декодування, не завантажуємо. Текстурами володіють TextureCache
+// і TextureArray.
+// Для Texture пікселі йдуть через UploadRing: робочий потік копіює їх у відображений PBO,
+// GL-потік лише ставить glTexSubImage2D зі зсуву буфера і не чекає на копіювання
+class TextureLoader
+{
+    public:
+        // ringBytes - розмір кільця PBO; 0 або GL без glBufferStorage - лише з пам'яті процесу
+        explicit TextureLoader(unsigned int threadCount = 0, size_t ringBytes = size_t(64) << 20)
+        {
+            if (ringBytes > 0 && UploadRing::supported())
+            {
+                ring = std::make_unique<UploadRing>(ringBytes);
+                if (!ring->valid())
+                {
+                    std::cout << "ERROR::TEXTURE_LOADER::UPLOAD_RING_MAP_FAILED" << std::endl;
+                    ring.reset();
+                }
+            }
+            pool = std::make_unique<ThreadPool>(threadCount);
+        }
+
+        // Повертає одразу; target отримає зображення в одному з наступних update()
+        void load(const std::string& path, const std::shared_ptr<Texture>& target)
+        {
+            std::weak_ptr<Texture> weakTarget = target;
+            submit(path, weakTarget, [weakTarget](const unsigned char* pixels, int width, int height, int channels) {
+                std::shared_ptr<Texture> texture = weakTarget.lock();
+                if (!texture)
+                    return false;
+                texture->upload(pixels, width, height, channels);
+                return true;
+            });
+        }
+
+        // Довільне призначення (шар TextureArray тощо); пікселі - у пам'яті процесу.
+        // prepare - важка частина підготовки, поза GL-потоком
+        void load(const std::string& path, TextureUpload upload, TexturePrepare prepare = nullptr)
+        {
+            submit(path, std::weak_ptr<Texture>(), std::move(upload), std::move(prepare));
+        }
+
+        // GL-потік, раз на кадр. Завантажує декодовані зображення, доки не вичерпано budgetMs;
+        // щонайменше одне за виклик, щоб велика текстура не застрягла в черзі
+        void update(double budgetMs)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            if (ring)
+                ring->retire();
+
+            Decoded decoded;
+            while (results.pop(decoded))
+            {
+                ready.push_back(std::move(decoded));
+            }
+
+            size_t uploaded = 0;
+            while (!ready.empty())
+            {
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                if (uploaded > 0 && elapsed.count() >= budgetMs)
+                    break;
+
+                Decoded& next = ready.front();
+                bool loaded = false;
+                if (next.streamed)
+                {
+                    // Ділянка кільця повертається, коли GPU дочитає її (fence)
+                    std::shared_ptr<Texture> texture = next.texture.lock();
+                    GLsync fence = 0;
+                    if (texture)
+                    {
+                        texture->upload(ring->buffer, next.slot.offset, next.width, next.height, next.channels);
+                        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                        loaded = true;
+                    }
+                    ring->release(next.slot, fence);
+                }
+                // Ціль могли звільнити під час декодування - тоді лише відкидаємо пікселі
+                else if (next.pixels)
+                {
+                    loaded = next.upload(next.pixels, next.width, next.height, next.channels);
+                }
+                else if (!next.prepared.empty())
+                {
+                    loaded = next.upload(next.prepared.data(), next.width, next.height, next.channels);
+                }
+
+                if (loaded)
+                {
+                    uploaded++;
+                    std::cout << "Loaded texture: " << next.path << " (" << next.width << "x" << next.height
+                              << ", " << next.channels << " channels)" << std::endl;
+                }
+                else if (!next.pixels && !next.streamed && next.prepared.empty())
+                {
+                    std::cout << "ERROR::TEXTURE::FAILED_TO_LOAD " << next.path << ": "
+                              << (next.error ? next.error : "unknown") << std::endl;
+                }
+
+                stbi_image_free(next.pixels);
+                ready.pop_front();
+                pending--;
+            }
+        }
+
+        // Дочекатися всіх запитаних текстур (екран завантаження)
+        void finish()
+        {
+            while (pending > 0)
+            {
+                update(1.0e9);
+                if (pending > 0)
+                    std::this_thread::yield();
+            }
+        }
+
+        size_t pendingCount() const
+        {
+            return pending;
+        }
+
+        // Спершу зупинити робочі потоки - лише тоді черга результатів має одного власника.
+        // Потоки, що чекають місця в кільці, будить stop()
+        ~TextureLoader()
+        {
+            if (ring)
+                ring->stop();
+            pool.reset();
+
+            Decoded decoded;
+            while (results.pop(decoded))
+            {
+                stbi_image_free(decoded.pixels);
+            }
+            for (Decoded& left : ready)
+            {
+                stbi_image_free(left.pixels);
+            }
+        }
+
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+    private:
+        struct Decoded
+        {
+            TextureUpload upload;
+            std::weak_ptr<Texture> texture;
+            std::string path;
+            unsigned char* pixels = nullptr;
+            // Результат TexturePrepare, pixels звільнено
+            std::vector<unsigned char> prepared;
+            // Пікселі вже в кільці PBO (slot), pixels звільнено
+            bool streamed = false;
+            UploadSlot slot;
+            int width = 0, height = 0, channels = 0;
+            const char* error = nullptr;
+        };
+
+        // texture - ціль для шляху через кільце; порожній - лише upload з пам'яті процесу
+        void submit(const std::string& path, std::weak_ptr<Texture> texture, TextureUpload upload,
+                    TexturePrepare prepare = nullptr)
+        {
+            pending++;
+
+            pool->submit([this, path, texture, upload, prepare]() {
+                Decoded decoded;
+                decoded.upload = upload;
+                decoded.texture = texture;
+                decoded.path = path;
+                // Прапорець stb глобальний; потокова версія не заважає іншим декодерам
+                stbi_set_flip_vertically_on_load_thread(true);
+                decoded.pixels = stbi_load(path.c_str(), &decoded.width, &decoded.height, &decoded.channels, 0);
+                decoded.error = decoded.pixels ? nullptr : stbi_failure_reason();
+
+                if (decoded.pixels && prepare)
+                {
+                    decoded.prepared = prepare(decoded.pixels, decoded.width, decoded.height, decoded.channels);
+                    stbi_image_free(decoded.pixels);
+                    decoded.pixels = nullptr;
+                }
+
+                // Ціль ще жива - копія у відображений PBO тут, а не в драйвері на GL-потоці
+                size_t bytes = size_t(decoded.width) * decoded.height * decoded.channels;
+                if (decoded.pixels && ring && !texture.expired() && ring->allocate(bytes, decoded.slot))
+                {
+                    std::memcpy(decoded.slot.data, decoded.pixels, bytes);
+                    stbi_image_free(decoded.pixels);
+                    decoded.pixels = nullptr;
+                    decoded.streamed = true;
+                }
+                results.push(std::move(decoded));
+            });
+        }
+
+        std::unique_ptr<UploadRing> ring;
+        MpscQueue<Decoded> results;
+        // Декодовані, але ще не завантажені через бюджет кадру (лише GL-потік)
+        std::deque<Decoded> ready;
+        size_t pending = 0;
+        std::unique_ptr<ThreadPool> pool;
+};
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+#include "texture.h"
+#include "texture_file.h"
+#include "mapped_file.h"
+#include "frustum.h"
+
+// Потокове завантаження рівнів міпмап зварених текстур (.tex). Текстура стартує з грубого
+// рівня (не більше START_SIZE пікселів), далі в GPU лишається лише ланцюжок від найдетальнішого
+// рівня, потрібного на екрані: рівень рахується з розміру об'єкта в пікселях (request() під час
+// обходу сцени). Дрібніші рівні довантажуються з відображеного файлу в межах бюджету
+// відеопам'яті, непотрібні - вивантажуються. Незмінне сховище не звільняє окремі рівні, тож
+// зміна рівня - нове сховище лише з потрібних рівнів (ID текстури змінюється між кадрами):
+// рівні, що вже в GPU, копіюються на GPU, з файлу читаються лише нові, їхні сторінки ОС
+// підвантажує наперед, за кадр до завантаження. Будь-яка зміна рівня - підвищення, пониження
+// чи повернення невидимої текстури до стартового - рахується в бюджеті кадру update()
+class TextureStreamer
+{
+    public:
+        // Найбільший розмір стартового рівня
+        static const uint32_t START_SIZE = 64;
+        // Стільки кадрів без request() текстура тримає рівень, далі повертається до стартового
+        static const uint64_t KEEP_FRAMES = 120;
+
+        size_t budgetBytes;
+        // Зсув рівня: > 0 - грубіші рівні (економія пам'яті), < 0 - детальніші
+        float mipBias = 0.0f;
+
+        explicit TextureStreamer(size_t budgetBytes = size_t(256) << 20)
+        : budgetBytes(budgetBytes)
+        {}
+
+        // Взяти текстуру під керування: стартовий рівень одразу з cookedPath.
+        // false - файлу немає або він пошкоджений
+        bool add(const std::shared_ptr<Texture>& texture, const std::string& cookedPath)
+        {
+            std::unique_ptr<MappedFile> file = std::make_unique<MappedFile>(cookedPath);
+            if (!file->valid() || !TextureFile::valid(file->data, file->size))
+                return false;
+
+            const TextureFileHeader& header = TextureFile::header(file->data);
+            const TextureFileLevel* levels = TextureFile::levels(file->data);
+            uint32_t startLevel = 0;
+            while (startLevel + 1 < header.levelCount &&
+                   std::max(levels[startLevel].width, levels[startLevel].height) > START_SIZE)
+            {
+                startLevel++;
+            }
+
+            if (!texture->uploadCooked(file->data, file->size, startLevel))
+                return false;
+
+            Entry& entry = entries[texture.get()];
+            entry.texture = texture;
+            entry.file = std::move(file);
+            entry.path = cookedPath;
+            entry.startLevel = startLevel;
+            entry.residentLevel = startLevel;
+            entry.residentBytes = chainBytes(entry, startLevel);
+            entry.requestedLevel = startLevel;
+            entry.prefetchedLevel = startLevel;
+            entry.lastRequestFrame = frame;
+            return true;
+        }
+
+        // Розмір об'єкта на екрані в пікселях (діаметр описаної сфери меж), fovDegrees - Camera::Fov
+        static float projectedSize(const AABB& bounds, const glm::vec3& viewPos, float fovDegrees, int viewportHeight)
+        {
+            float radius = glm::length(bounds.extent());
+            // Камера всередині меж - потрібен найдетальніший рівень
+            float distance = std::max(glm::length(bounds.center() - viewPos) - radius, 1.0e-3f);
+            float pixelsPerUnit = viewportHeight * 0.5f / std::tan(glm::radians(fovDegrees) * 0.5f);
+            return 2.0f * radius / distance * pixelsPerUnit;
+        }
+
+        // Під час обходу видимих об'єктів: текстура вкриває об'єкт розміром screenPixels.
+        // Текстури не під керуванням стрімера ігноруються
+        void request(const Texture* texture, float screenPixels)
+        {
+            auto found = entries.find(texture);
+            if (found == entries.end())
+                return;
+
+            Entry& entry = found->second;
+            const TextureFileHeader& header = TextureFile::header(entry.file->data);
+            // Тексель на піксель: log2(розмір текстури / розмір на екрані)
+            float texels = float(std::max(header.width, header.height));
+            float level = std::log2(texels / std::max(screenPixels, 1.0f)) + mipBias;
+            uint32_t wanted = static_cast<uint32_t>(std::clamp(std::floor(level), 0.0f, float(header.levelCount - 1)));
+
+            if (entry.lastRequestFrame != frame)
+                entry.requestedLevel = wanted;
+            else
+                entry.requestedLevel = std::min(entry.requestedLevel, wanted);
+            entry.lastRequestFrame = frame;
+        }
+
+        // Раз на кадр, до малювання: застосувати запити попереднього кадру. uploadBytes - скільки
+        // байтів нових ланцюжків рівнів створити за кадр (щонайменше одну зміну рівня)
+        void update(size_t uploadBytes)
+        {
+            size_t total = 0;
+            std::vector<Entry*> upgrades;
+            std::vector<Entry*> decays;
+            for (auto it = entries.begin(); it != entries.end();)
+            {
+                Entry& entry = it->second;
+                if (entry.texture.expired())
+                {
+                    it = entries.erase(it);
+                    continue;
+                }
+
+                entry.targetLevel = entry.lastRequestFrame == frame ? entry.requestedLevel : entry.residentLevel;
+                if (entry.targetLevel < entry.residentLevel)
+                    upgrades.push_back(&entry);
+                // Давно не видима - назад до стартового рівня, коли в кадрі лишиться бюджет
+                else if (frame - entry.lastRequestFrame > KEEP_FRAMES && entry.residentLevel < entry.startLevel)
+                    decays.push_back(&entry);
+                total += entry.residentBytes;
+                ++it;
+            }
+
+            // Спершу найбільший дефіцит деталізації
+            std::sort(upgrades.begin(), upgrades.end(), [](const Entry* a, const Entry* b) {
+                return a->residentLevel - a->targetLevel > b->residentLevel - b->targetLevel;
+            });
+            // Найдавніше видимі першими
+            std::sort(decays.begin(), decays.end(), [](const Entry* a, const Entry* b) {
+                return a->lastRequestFrame < b->lastRequestFrame;
+            });
+
+            size_t uploaded = 0;
+            for (Entry* entry : upgrades)
+            {
+                if (uploaded > 0 && uploaded >= uploadBytes)
+                    break;
+
+                // Нові рівні ще не запитані в ОС - запитати, а поки взяти вже підвантажені
+                uint32_t level = entry->targetLevel;
+                if (level < entry->prefetchedLevel)
+                {
+                    prefetch(*entry, level);
+                    std::swap(level, entry->prefetchedLevel);
+                }
+                if (level >= entry->residentLevel)
+                    continue;
+
+                if (total + chainBytes(*entry, level) - entry->residentBytes > budgetBytes)
+                {
+                    total -= evict(total + chainBytes(*entry, level) - entry->residentBytes - budgetBytes, entry,
+                                   uploadBytes, uploaded);
+                }
+
+                // Бюджету не вистачає навіть після вивантаження - найдетальніший рівень, що влазить
+                while (level < entry->residentLevel &&
+                       total + chainBytes(*entry, level) - entry->residentBytes > budgetBytes)
+                {
+                    level++;
+                }
+                if (level >= entry->residentLevel)
+                    continue;
+
+                total -= entry->residentBytes;
+                setResidentLevel(*entry, level, uploaded);
+                total += entry->residentBytes;
+            }
+
+            for (Entry* entry : decays)
+            {
+                if (uploaded > 0 && uploaded >= uploadBytes)
+                    break;
+                // Могла вже піти на вивантаження
+                if (entry->residentLevel >= entry->startLevel)
+                    continue;
+
+                total -= entry->residentBytes;
+                setResidentLevel(*entry, entry->startLevel, uploaded);
+                total += entry->residentBytes;
+            }
+
+            residentTotal = total;
+            frame++;
+        }
+
+        size_t textureCount() const
+        {
+            return entries.size();
+        }
+
+        // Станом на останній update()
+        size_t memoryBytes() const
+        {
+            return residentTotal;
+        }
+
+        void print(std::ostream& out) const
+        {
+            out << "TEXTURE_STREAMER: " << entries.size() << " textures, " << (residentTotal >> 10) << " / "
+                << (budgetBytes >> 10) << " KiB" << std::endl;
+            for (const auto& item : entries)
+            {
+                const Entry& entry = item.second;
+                const TextureFileLevel& level = TextureFile::levels(entry.file->data)[entry.residentLevel];
+                out << "  " << entry.path << " - mip " << entry.residentLevel << " (" << level.width << "x"
+                    << level.height << "), " << (entry.residentBytes >> 10) << " KiB" << std::endl;
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            std::weak_ptr<Texture> texture;
+            std::unique_ptr<MappedFile> file;
+            std::string path;
+            uint32_t startLevel = 0;
+            uint32_t residentLevel = 0;
+            uint32_t requestedLevel = 0;
+            uint32_t targetLevel = 0;
+            // Сторінки файлу від цього рівня запитані в ОС (prefetch)
+            uint32_t prefetchedLevel = 0;
+            size_t residentBytes = 0;
+            uint64_t lastRequestFrame = 0;
+        };
+
+        // Байтів у GPU для ланцюжка від level до 1x1
+        static size_t chainBytes(const Entry& entry, uint32_t level)
+        {
+            const TextureFileHeader& header = TextureFile::header(entry.file->data);
+            const TextureFileLevel* levels = TextureFile::levels(entry.file->data);
+            size_t bytes = 0;
+            for (uint32_t i = level; i < header.levelCount; ++i)
+            {
+                bytes += levels[i].size;
+            }
+            return bytes;
+        }
+
+        // Нове сховище з рівня level; його розмір додається до uploaded (бюджет кадру)
+        void setResidentLevel(Entry& entry, uint32_t level, size_t& uploaded)
+        {
+            std::shared_ptr<Texture> texture = entry.texture.lock();
+            if (!texture || !texture->restreamCooked(entry.file->data, entry.file->size, level, entry.residentLevel))
+                return;
+            entry.residentLevel = level;
+            entry.residentBytes = chainBytes(entry, level);
+            entry.prefetchedLevel = std::max(entry.prefetchedLevel, level);
+            uploaded += entry.residentBytes;
+        }
+
+        // Рівні від level до поточного резидентного: їх читатиме наступне підвищення
+        static void prefetch(const Entry& entry, uint32_t level)
+        {
+            const TextureFileLevel* levels = TextureFile::levels(entry.file->data);
+            uint64_t begin = levels[level].offset;
+            uint64_t end = levels[entry.residentLevel].offset;
+            entry.file->prefetch(static_cast<size_t>(begin), static_cast<size_t>(end - begin));
+        }
+
+        // Звільнити щонайменше needed байтів: спершу текстури, яких давно не видно, далі ті,
+        // що тримають детальніший рівень, ніж зараз потрібно. Зупиняється й на вичерпаному бюджеті
+        // кадру uploadBytes. Повертає звільнене
+        size_t evict(size_t needed, const Entry* keep, size_t uploadBytes, size_t& uploaded)
+        {
+            std::vector<Entry*> candidates;
+            for (auto& item : entries)
+            {
+                Entry& entry = item.second;
+                if (&entry != keep && entry.residentLevel < std::max(entry.targetLevel, entry.startLevel))
+                    candidates.push_back(&entry);
+            }
+            std::sort(candidates.begin(), candidates.end(), [](const Entry* a, const Entry* b) {
+                return a->lastRequestFrame < b->lastRequestFrame;
+            });
+
+            size_t freed = 0;
+            for (Entry* entry : candidates)
+            {
+                if (freed >= needed || (uploaded > 0 && uploaded >= uploadBytes))
+                    break;
+                // Невидимі - до стартового рівня, видимі - лише до потрібного
+                uint32_t level = entry->lastRequestFrame == frame ? entry->targetLevel : entry->startLevel;
+                if (level <= entry->residentLevel)
+                    continue;
+                size_t before = entry->residentBytes;
+                setResidentLevel(*entry, level, uploaded);
+                freed += before - entry->residentBytes;
+            }
+            return freed;
+        }
+
+        std::unordered_map<const Texture*, Entry> entries;
+        uint64_t frame = 0;
+        size_t residentTotal = 0;
+};
+
+#endif
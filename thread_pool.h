@@ -0,0 +1,86 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+// Пул робочих потоків для CPU-роботи без GL (декодування зображень тощо).
+// Завдання беруться в порядку надходження; результати повертаються через MpscQueue
+class ThreadPool
+{
+    public:
+        // 0 - усі ядра, крім одного (головний потік з GL-контекстом)
+        explicit ThreadPool(unsigned int threadCount = 0)
+        {
+            if (threadCount == 0)
+                threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+            for (unsigned int i = 0; i < threadCount; ++i)
+            {
+                workers.emplace_back([this]() { run(); });
+            }
+        }
+
+        void submit(std::function<void()> job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                jobs.push_back(std::move(job));
+            }
+            wake.notify_one();
+        }
+
+        size_t threadCount() const
+        {
+            return workers.size();
+        }
+
+        // Незавершені завдання в черзі відкидаються, поточні доробляються
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+                jobs.clear();
+            }
+            wake.notify_all();
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+
+        void run()
+        {
+            for (;;)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                    if (stopping)
+                        return;
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+                job();
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,195 @@
+// texcook - підготовка текстур для рушія: декодування stb_image, ланцюжок міпмап
+// і (за бажанням) стиснення в BC1 / BC3 / BC7, запис у .tex (texture_file.h).
+//
+//   texcook <вхід> [вихід.tex] [--format rgba8|bc1|bc3|bc7] [--filter box|kaiser] [--linear] [--clamp]
+//
+// --linear - дані не колір (нормалі, шорсткість): без перетворення sRGB при фільтрації
+// --clamp  - текстура не тайлиться, фільтр міпмап не бере пікселі з протилежного краю
+// Без вихідного шляху пише поруч із вхідним: res/a.png -> res/a.png.tex, його й шукає TextureCache.
+// У заголовок записується хеш вхідного файлу - після зміни зображення рушій ігнорує старий .tex
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../stb_image.h"
+#include "../texture_file.h"
+#include "../mapped_file.h"
+#include "texture_codec.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string input;
+        std::string output;
+        TextureFileFormat format = TextureFileFormat::BC7;
+        TextureCodec::MipFilter filter = TextureCodec::MipFilter::KAISER;
+        bool srgb = true;
+        bool wrap = true;
+    };
+
+    void usage()
+    {
+        std::cout << "usage: texcook <input> [output.tex] [--format rgba8|bc1|bc3|bc7] "
+                     "[--filter box|kaiser] [--linear] [--clamp]" << std::endl;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--format" && i + 1 < argc)
+            {
+                std::string value = argv[++i];
+                if (value == "rgba8")
+                    options.format = TextureFileFormat::RGBA8;
+                else if (value == "bc1")
+                    options.format = TextureFileFormat::BC1;
+                else if (value == "bc3")
+                    options.format = TextureFileFormat::BC3;
+                else if (value == "bc7")
+                    options.format = TextureFileFormat::BC7;
+                else
+                    return false;
+            }
+            else if (arg == "--filter" && i + 1 < argc)
+            {
+                std::string value = argv[++i];
+                if (value == "box")
+                    options.filter = TextureCodec::MipFilter::BOX;
+                else if (value == "kaiser")
+                    options.filter = TextureCodec::MipFilter::KAISER;
+                else
+                    return false;
+            }
+            else if (arg == "--linear")
+                options.srgb = false;
+            else if (arg == "--clamp")
+                options.wrap = false;
+            else if (arg.rfind("--", 0) == 0)
+                return false;
+            else if (options.input.empty())
+                options.input = arg;
+            else if (options.output.empty())
+                options.output = arg;
+            else
+                return false;
+        }
+
+        if (options.input.empty())
+            return false;
+        if (options.output.empty())
+            options.output = TextureFile::cookedPath(options.input);
+        return true;
+    }
+
+    uint64_t align(uint64_t offset)
+    {
+        return (offset + TEXTURE_FILE_ALIGNMENT - 1) / TEXTURE_FILE_ALIGNMENT * TEXTURE_FILE_ALIGNMENT;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage();
+        return 1;
+    }
+
+    MappedFile source(options.input);
+    if (!source.valid())
+    {
+        std::cout << "ERROR::TEXCOOK::FAILED_TO_LOAD " << options.input << std::endl;
+        return 1;
+    }
+
+    // Той самий порядок рядків, що й у Texture / TextureLoader
+    stbi_set_flip_vertically_on_load(true);
+    int width, height, channels;
+    unsigned char* pixels = stbi_load_from_memory(source.data, static_cast<int>(source.size),
+                                                  &width, &height, &channels, 4);
+    if (!pixels)
+    {
+        std::cout << "ERROR::TEXCOOK::FAILED_TO_LOAD " << options.input << ": " << stbi_failure_reason() << std::endl;
+        return 1;
+    }
+
+    TextureCodec::Image level = TextureCodec::fromBytes(pixels, width, height, options.srgb);
+    stbi_image_free(pixels);
+
+    // Кожен рівень фільтрується з попереднього у лінійному просторі
+    std::vector<std::vector<unsigned char>> levels;
+    std::vector<TextureFileLevel> table;
+    while (true)
+    {
+        std::vector<unsigned char> rgba = TextureCodec::toBytes(level, options.srgb);
+        levels.push_back(TextureCodec::encodeLevel(options.format, rgba, level.width, level.height));
+        table.push_back({0, levels.back().size(), uint32_t(level.width), uint32_t(level.height)});
+
+        if (level.width == 1 && level.height == 1)
+            break;
+        level = TextureCodec::downsample(level, options.filter, options.wrap);
+    }
+
+    TextureFileHeader header = {};
+    header.magic = TEXTURE_FILE_MAGIC;
+    header.version = TEXTURE_FILE_VERSION;
+    header.format = uint32_t(options.format);
+    header.flags = options.srgb ? TEXTURE_FILE_SRGB : 0;
+    header.width = uint32_t(width);
+    header.height = uint32_t(height);
+    header.levelCount = uint32_t(levels.size());
+    header.sourceHash = hashBytes(source.data, source.size);
+
+    uint64_t offset = sizeof(TextureFileHeader) + table.size() * sizeof(TextureFileLevel);
+    for (TextureFileLevel& entry : table)
+    {
+        offset = align(offset);
+        entry.offset = offset;
+        offset += entry.size;
+    }
+
+    // Через тимчасовий файл: рушій ніколи не побачить наполовину записаний .tex
+    std::string temporary = options.output + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            std::cout << "ERROR::TEXCOOK::FAILED_TO_WRITE " << options.output << std::endl;
+            return 1;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(TextureFileLevel));
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            static const char padding[TEXTURE_FILE_ALIGNMENT] = {};
+            file.write(padding, std::streamsize(table[i].offset - uint64_t(file.tellp())));
+            file.write(reinterpret_cast<const char*>(levels[i].data()), std::streamsize(levels[i].size()));
+        }
+        if (!file)
+        {
+            std::cout << "ERROR::TEXCOOK::FAILED_TO_WRITE " << options.output << std::endl;
+            return 1;
+        }
+    }
+    if (std::rename(temporary.c_str(), options.output.c_str()) != 0)
+    {
+        std::cout << "ERROR::TEXCOOK::FAILED_TO_WRITE " << options.output << std::endl;
+        std::remove(temporary.c_str());
+        return 1;
+    }
+
+    static const char* formatNames[] = {"rgba8", "bc1", "bc3", "bc7"};
+    std::cout << "Cooked texture: " << options.input << " -> " << options.output << " (" << width << "x" << height
+              << ", " << levels.size() << " levels, " << formatNames[header.format]
+              << (options.srgb ? " srgb" : "") << ", " << (offset >> 10) << " KiB)" << std::endl;
+    return 0;
+}
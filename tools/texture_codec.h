@@ -0,0 +1,573 @@
+#ifndef TEXTURE_CODEC_H
+#define TEXTURE_CODEC_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "../texture_file.h"
+
+// Офлайн-обробка текстур для texcook: ланцюжок міпмап у лінійному просторі і стиснення
+// в BC1 / BC3 / BC7 на CPU. Лише для інструмента - рушій читає готові .tex
+namespace TextureCodec
+{
+    // RGBA, float, лінійні значення (колір sRGB уже розкодований)
+    struct Image
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<float> rgba;
+
+        float* pixel(int x, int y)
+        {
+            return &rgba[(size_t(y) * width + x) * 4];
+        }
+
+        const float* pixel(int x, int y) const
+        {
+            return &rgba[(size_t(y) * width + x) * 4];
+        }
+    };
+
+    enum class MipFilter {
+        BOX,        // середнє 2x2, найшвидший
+        KAISER      // вікно Кайзера: різкіші дальні рівні без муару
+    };
+
+    inline float srgbToLinear(float c)
+    {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    inline float linearToSrgb(float c)
+    {
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    // 8-бітні RGBA -> Image; srgb - RGB у гамі sRGB (альфа завжди лінійна)
+    inline Image fromBytes(const unsigned char* pixels, int width, int height, bool srgb)
+    {
+        Image image;
+        image.width = width;
+        image.height = height;
+        image.rgba.resize(size_t(width) * height * 4);
+        for (size_t i = 0; i < image.rgba.size(); ++i)
+        {
+            float c = pixels[i] / 255.0f;
+            image.rgba[i] = (srgb && i % 4 != 3) ? srgbToLinear(c) : c;
+        }
+        return image;
+    }
+
+    inline std::vector<unsigned char> toBytes(const Image& image, bool srgb)
+    {
+        std::vector<unsigned char> bytes(image.rgba.size());
+        for (size_t i = 0; i < bytes.size(); ++i)
+        {
+            float c = std::clamp(image.rgba[i], 0.0f, 1.0f);
+            if (srgb && i % 4 != 3)
+                c = linearToSrgb(c);
+            bytes[i] = static_cast<unsigned char>(std::lround(c * 255.0f));
+        }
+        return bytes;
+    }
+
+    // Модифікована функція Бесселя нульового порядку (ряд)
+    inline float besselI0(float x)
+    {
+        float sum = 1.0f, term = 1.0f;
+        for (int k = 1; k < 20; ++k)
+        {
+            term *= (x / (2.0f * k)) * (x / (2.0f * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Ваги для зменшення вдвічі: відстані від центру вихідного пікселя в пікселях
+    // вихідного рівня (0.5, 1.5, ...), sinc з вікном Кайзера
+    inline std::vector<float> kaiserWeights(int radius = 3, float alpha = 4.0f)
+    {
+        const float pi = 3.14159265358979f;
+        std::vector<float> weights(radius * 2);
+        float sum = 0.0f;
+        for (int i = 0; i < radius * 2; ++i)
+        {
+            float x = (i - radius + 0.5f) * 0.5f;       // у пікселях результату
+            float sinc = std::sin(pi * x) / (pi * x);
+            float t = x / (radius * 0.5f);
+            float window = besselI0(alpha * std::sqrt(std::max(0.0f, 1.0f - t * t))) / besselI0(alpha);
+            weights[i] = sinc * window;
+            sum += weights[i];
+        }
+        for (float& w : weights)
+        {
+            w /= sum;
+        }
+        return weights;
+    }
+
+    // Наступний рівень (половина розміру, не менше 1). wrap - текстура тайлиться (GL_REPEAT),
+    // фільтр бере пікселі з протилежного краю; інакше край повторюється
+    inline Image downsample(const Image& source, MipFilter filter, bool wrap)
+    {
+        Image result;
+        result.width = std::max(1, source.width / 2);
+        result.height = std::max(1, source.height / 2);
+        result.rgba.assign(size_t(result.width) * result.height * 4, 0.0f);
+
+        auto address = [wrap](int i, int size) {
+            if (wrap)
+                return ((i % size) + size) % size;
+            return std::clamp(i, 0, size - 1);
+        };
+
+        std::vector<float> weights = filter == MipFilter::KAISER ? kaiserWeights() : std::vector<float>{0.5f, 0.5f};
+        const int radius = static_cast<int>(weights.size()) / 2;
+
+        // Непарний розмір: вісь, що не зменшується, фільтрується з вагою 1
+        const bool halveX = source.width > 1;
+        const bool halveY = source.height > 1;
+
+        // Спершу по X у проміжне зображення, потім по Y
+        Image horizontal;
+        horizontal.width = result.width;
+        horizontal.height = source.height;
+        horizontal.rgba.assign(size_t(horizontal.width) * horizontal.height * 4, 0.0f);
+        for (int y = 0; y < source.height; ++y)
+        {
+            for (int x = 0; x < result.width; ++x)
+            {
+                float* out = horizontal.pixel(x, y);
+                if (!halveX)
+                {
+                    std::copy(source.pixel(x, y), source.pixel(x, y) + 4, out);
+                    continue;
+                }
+                for (int k = 0; k < radius * 2; ++k)
+                {
+                    const float* in = source.pixel(address(2 * x - radius + 1 + k, source.width), y);
+                    for (int c = 0; c < 4; ++c)
+                        out[c] += in[c] * weights[k];
+                }
+            }
+        }
+
+        for (int y = 0; y < result.height; ++y)
+        {
+            for (int x = 0; x < result.width; ++x)
+            {
+                float* out = result.pixel(x, y);
+                if (!halveY)
+                {
+                    std::copy(horizontal.pixel(x, y), horizontal.pixel(x, y) + 4, out);
+                    continue;
+                }
+                for (int k = 0; k < radius * 2; ++k)
+                {
+                    const float* in = horizontal.pixel(x, address(2 * y - radius + 1 + k, source.height));
+                    for (int c = 0; c < 4; ++c)
+                        out[c] += in[c] * weights[k];
+                }
+            }
+        }
+        return result;
+    }
+
+    // ---- Блоки BC ----
+
+    // Блок 4x4 з рівня; пікселі за межами неповного блока повторюють край
+    inline void fetchBlock(const unsigned char* rgba, int width, int height, int bx, int by, unsigned char block[64])
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            for (int x = 0; x < 4; ++x)
+            {
+                int sx = std::min(bx * 4 + x, width - 1);
+                int sy = std::min(by * 4 + y, height - 1);
+                const unsigned char* p = rgba + (size_t(sy) * width + sx) * 4;
+                std::copy(p, p + 4, block + (y * 4 + x) * 4);
+            }
+        }
+    }
+
+    // Головна вісь розкиду кольорів (степеневий метод на коваріації), для вибору кінців відрізка
+    inline void principalAxis(const float points[][4], int count, int channels, float mean[4], float axis[4])
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            mean[c] = 0.0f;
+            axis[c] = 0.0f;
+        }
+        for (int i = 0; i < count; ++i)
+            for (int c = 0; c < channels; ++c)
+                mean[c] += points[i][c] / count;
+
+        float covariance[4][4] = {};
+        for (int i = 0; i < count; ++i)
+            for (int a = 0; a < channels; ++a)
+                for (int b = 0; b < channels; ++b)
+                    covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+
+        for (int c = 0; c < channels; ++c)
+            axis[c] = 1.0f;
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            float next[4] = {};
+            float length = 0.0f;
+            for (int a = 0; a < channels; ++a)
+            {
+                for (int b = 0; b < channels; ++b)
+                    next[a] += covariance[a][b] * axis[b];
+                length += next[a] * next[a];
+            }
+            if (length < 1.0e-12f)
+                break;
+            length = std::sqrt(length);
+            for (int c = 0; c < channels; ++c)
+                axis[c] = next[c] / length;
+        }
+    }
+
+    // Кінці відрізка: крайні проєкції пікселів на головну вісь
+    inline void endpointsAlongAxis(const float points[][4], int count, int channels, float low[4], float high[4])
+    {
+        float mean[4], axis[4];
+        principalAxis(points, count, channels, mean, axis);
+
+        float minT = 0.0f, maxT = 0.0f;
+        for (int i = 0; i < count; ++i)
+        {
+            float t = 0.0f;
+            for (int c = 0; c < channels; ++c)
+                t += (points[i][c] - mean[c]) * axis[c];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+        for (int c = 0; c < channels; ++c)
+        {
+            low[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+            high[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+        }
+    }
+
+    inline uint16_t packRgb565(const float color[4])
+    {
+        int r = std::clamp(int(std::lround(color[0] * 31.0f / 255.0f)), 0, 31);
+        int g = std::clamp(int(std::lround(color[1] * 63.0f / 255.0f)), 0, 63);
+        int b = std::clamp(int(std::lround(color[2] * 31.0f / 255.0f)), 0, 31);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    inline void unpackRgb565(uint16_t packed, int color[3])
+    {
+        int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    inline int colorDistance(const unsigned char* a, const int b[3])
+    {
+        int dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+        return dr * dr + dg * dg + db * db;
+    }
+
+    // Кольорова частина BC1 / BC3: 565-кінці і 2-бітні індекси, завжди 4-кольоровий режим
+    inline void encodeColorBlock(const unsigned char block[64], unsigned char out[8])
+    {
+        float points[16][4];
+        for (int i = 0; i < 16; ++i)
+            for (int c = 0; c < 4; ++c)
+                points[i][c] = block[i * 4 + c];
+
+        float low[4], high[4];
+        endpointsAlongAxis(points, 16, 3, low, high);
+
+        uint16_t color0 = packRgb565(high);
+        uint16_t color1 = packRgb565(low);
+        // 4-кольоровий режим вимагає color0 > color1
+        if (color0 < color1)
+            std::swap(color0, color1);
+
+        uint32_t indices = 0;
+        if (color0 != color1)
+        {
+            int palette[4][3];
+            unpackRgb565(color0, palette[0]);
+            unpackRgb565(color1, palette[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            for (int i = 0; i < 16; ++i)
+            {
+                int best = 0, bestDistance = colorDistance(block + i * 4, palette[0]);
+                for (int p = 1; p < 4; ++p)
+                {
+                    int distance = colorDistance(block + i * 4, palette[p]);
+                    if (distance < bestDistance)
+                    {
+                        best = p;
+                        bestDistance = distance;
+                    }
+                }
+                indices |= uint32_t(best) << (i * 2);
+            }
+        }
+
+        out[0] = color0 & 0xFF;
+        out[1] = color0 >> 8;
+        out[2] = color1 & 0xFF;
+        out[3] = color1 >> 8;
+        for (int i = 0; i < 4; ++i)
+            out[4 + i] = (indices >> (i * 8)) & 0xFF;
+    }
+
+    // Альфа BC3: 8-значна палітра між alpha0 > alpha1, 3-бітні індекси
+    inline void encodeAlphaBlock(const unsigned char block[64], unsigned char out[8])
+    {
+        int minAlpha = 255, maxAlpha = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            minAlpha = std::min(minAlpha, int(block[i * 4 + 3]));
+            maxAlpha = std::max(maxAlpha, int(block[i * 4 + 3]));
+        }
+
+        out[0] = static_cast<unsigned char>(maxAlpha);
+        out[1] = static_cast<unsigned char>(minAlpha);
+        uint64_t indices = 0;
+        if (maxAlpha != minAlpha)
+        {
+            int palette[8];
+            palette[0] = maxAlpha;
+            palette[1] = minAlpha;
+            for (int p = 1; p < 7; ++p)
+                palette[p + 1] = ((7 - p) * maxAlpha + p * minAlpha) / 7;
+
+            for (int i = 0; i < 16; ++i)
+            {
+                int alpha = block[i * 4 + 3];
+                int best = 0;
+                for (int p = 1; p < 8; ++p)
+                {
+                    if (std::abs(alpha - palette[p]) < std::abs(alpha - palette[best]))
+                        best = p;
+                }
+                indices |= uint64_t(best) << (i * 3);
+            }
+        }
+        for (int i = 0; i < 6; ++i)
+            out[2 + i] = (indices >> (i * 8)) & 0xFF;
+    }
+
+    // Запис бітів BC7 від молодшого біта блока
+    struct BitWriter
+    {
+        unsigned char* out;
+        int position = 0;
+
+        void write(uint32_t value, int bits)
+        {
+            for (int i = 0; i < bits; ++i, ++position)
+            {
+                if ((value >> i) & 1)
+                    out[position / 8] |= static_cast<unsigned char>(1 << (position % 8));
+            }
+        }
+    };
+
+    const int BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    // Кінець BC7 режиму 6: 7 біт на канал + спільний p-біт (значення = c << 1 | p).
+    // Обираємо p, що дає менший сумарний відхил по RGBA
+    inline void quantizeBc7Endpoint(const float value[4], int quantized[4], int& pbit)
+    {
+        float bestError = 1.0e30f;
+        for (int p = 0; p < 2; ++p)
+        {
+            int candidate[4];
+            float error = 0.0f;
+            for (int c = 0; c < 4; ++c)
+            {
+                candidate[c] = std::clamp(int(std::lround((value[c] - p) / 2.0f)), 0, 127);
+                float decoded = float((candidate[c] << 1) | p);
+                error += (decoded - value[c]) * (decoded - value[c]);
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                pbit = p;
+                std::copy(candidate, candidate + 4, quantized);
+            }
+        }
+    }
+
+    // Підбір 4-бітних індексів для кінців; повертає сумарну квадратичну похибку
+    inline int selectBc7Indices(const unsigned char block[64], const int e0[4], const int e1[4], int indices[16])
+    {
+        int palette[16][4];
+        for (int p = 0; p < 16; ++p)
+            for (int c = 0; c < 4; ++c)
+                palette[p][c] = ((64 - BC7_WEIGHTS4[p]) * e0[c] + BC7_WEIGHTS4[p] * e1[c] + 32) >> 6;
+
+        int total = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            int bestDistance = 1 << 30;
+            for (int p = 0; p < 16; ++p)
+            {
+                int distance = 0;
+                for (int c = 0; c < 4; ++c)
+                {
+                    int d = block[i * 4 + c] - palette[p][c];
+                    distance += d * d;
+                }
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    indices[i] = p;
+                }
+            }
+            total += bestDistance;
+        }
+        return total;
+    }
+
+    // BC7, лише режим 6: одна підмножина, RGBA разом, 16 рівнів інтерполяції. Дає більшу частину
+    // якості BC7 без перебору розбиттів на підмножини, які потребують режими 0-5 і 7
+    inline void encodeBc7Block(const unsigned char block[64], unsigned char out[16])
+    {
+        float points[16][4];
+        for (int i = 0; i < 16; ++i)
+            for (int c = 0; c < 4; ++c)
+                points[i][c] = block[i * 4 + c];
+
+        float low[4], high[4];
+        endpointsAlongAxis(points, 16, 4, low, high);
+
+        int q0[4], q1[4], p0 = 0, p1 = 0;
+        quantizeBc7Endpoint(low, q0, p0);
+        quantizeBc7Endpoint(high, q1, p1);
+
+        auto decode = [](const int q[4], int p, int e[4]) {
+            for (int c = 0; c < 4; ++c)
+                e[c] = (q[c] << 1) | p;
+        };
+
+        int e0[4], e1[4], indices[16];
+        decode(q0, p0, e0);
+        decode(q1, p1, e1);
+        int error = selectBc7Indices(block, e0, e1, indices);
+
+        // Уточнення кінців найменшими квадратами за знайденими індексами
+        for (int iteration = 0; iteration < 2 && error > 0; ++iteration)
+        {
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+            float ax[4] = {}, bx[4] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                float w = BC7_WEIGHTS4[indices[i]] / 64.0f;
+                float a = 1.0f - w;
+                aa += a * a;
+                ab += a * w;
+                bb += w * w;
+                for (int c = 0; c < 4; ++c)
+                {
+                    ax[c] += a * points[i][c];
+                    bx[c] += w * points[i][c];
+                }
+            }
+            float determinant = aa * bb - ab * ab;
+            if (std::fabs(determinant) < 1.0e-6f)
+                break;
+
+            float refinedLow[4], refinedHigh[4];
+            for (int c = 0; c < 4; ++c)
+            {
+                refinedLow[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+                refinedHigh[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+            }
+
+            int r0[4], r1[4], rp0 = 0, rp1 = 0, re0[4], re1[4], rindices[16];
+            quantizeBc7Endpoint(refinedLow, r0, rp0);
+            quantizeBc7Endpoint(refinedHigh, r1, rp1);
+            decode(r0, rp0, re0);
+            decode(r1, rp1, re1);
+            int refinedError = selectBc7Indices(block, re0, re1, rindices);
+            if (refinedError >= error)
+                break;
+
+            error = refinedError;
+            std::copy(r0, r0 + 4, q0);
+            std::copy(r1, r1 + 4, q1);
+            p0 = rp0;
+            p1 = rp1;
+            std::copy(rindices, rindices + 16, indices);
+        }
+
+        // Старший біт індексу пікселя 0 не зберігається і має бути 0: інакше міняємо кінці місцями
+        if (indices[0] >= 8)
+        {
+            std::swap(q0, q1);
+            std::swap(p0, p1);
+            for (int& index : indices)
+                index = 15 - index;
+        }
+
+        std::fill(out, out + 16, 0);
+        BitWriter writer = {out};
+        writer.write(1u << 6, 7);           // режим 6
+        for (int c = 0; c < 4; ++c)
+        {
+            writer.write(q0[c], 7);
+            writer.write(q1[c], 7);
+        }
+        writer.write(p0, 1);
+        writer.write(p1, 1);
+        writer.write(indices[0], 3);
+        for (int i = 1; i < 16; ++i)
+            writer.write(indices[i], 4);
+    }
+
+    // Рівень RGBA8 -> дані рівня у форматі format (для RGBA8 - копія)
+    inline std::vector<unsigned char> encodeLevel(TextureFileFormat format, const std::vector<unsigned char>& rgba,
+                                                  int width, int height)
+    {
+        if (format == TextureFileFormat::RGBA8)
+            return rgba;
+
+        std::vector<unsigned char> data(TextureFile::levelBytes(format, width, height));
+        const size_t blockBytes = format == TextureFileFormat::BC1 ? 8 : 16;
+        const int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+
+        unsigned char block[64];
+        for (int by = 0; by < blocksY; ++by)
+        {
+            for (int bx = 0; bx < blocksX; ++bx)
+            {
+                fetchBlock(rgba.data(), width, height, bx, by, block);
+                unsigned char* out = &data[(size_t(by) * blocksX + bx) * blockBytes];
+                switch (format)
+                {
+                    case TextureFileFormat::BC1:
+                        encodeColorBlock(block, out);
+                        break;
+                    case TextureFileFormat::BC3:
+                        encodeAlphaBlock(block, out);
+                        encodeColorBlock(block, out + 8);
+                        break;
+                    default:
+                        encodeBc7Block(block, out);
+                        break;
+                }
+            }
+        }
+        return data;
+    }
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef UPLOAD_RING_H
+#define UPLOAD_RING_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+// Ділянка кільця, виділена робочому потоку під пікселі одного зображення
+struct UploadSlot
+{
+    uint64_t id = 0;
+    size_t offset = 0;          // зсув у GL_PIXEL_UNPACK_BUFFER - "вказівник" для glTexSubImage2D
+    unsigned char* data = nullptr;
+};
+
+// Кільце GL_PIXEL_UNPACK_BUFFER, постійно відображене в пам'ять (glBufferStorage, GL 4.4).
+// Робочі потоки пишуть декодовані пікселі прямо у відображену пам'ять, GL-потік запускає
+// glTexSubImage2D зі зсуву буфера - копіювання веде драйвер/DMA, а не головний потік.
+// Ділянка повертається в кільце, коли спрацює її glFenceSync (GPU дочитав пікселі).
+// Звільнення - у порядку виділення, тож вільне місце завжди неперервне
+class UploadRing
+{
+    public:
+        static const size_t ALIGNMENT = 256;
+
+        GLuint buffer = 0;
+
+        explicit UploadRing(size_t capacity)
+        : capacity(capacity)
+        {
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER, capacity, nullptr, flags);
+            mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, capacity, flags));
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
+        // Постійне відображення - ядро з GL 4.4 (ARB_buffer_storage)
+        static bool supported()
+        {
+            return GLAD_GL_VERSION_4_4;
+        }
+
+        bool valid() const
+        {
+            return mapped != nullptr;
+        }
+
+        // Будь-який потік. Чекає, доки GL-потік не звільнить місце; false - зображення більше
+        // за кільце або кільце зупинене (тоді пікселі йдуть звичайним шляхом з пам'яті процесу)
+        bool allocate(size_t size, UploadSlot& slot)
+        {
+            size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+            if (!mapped || size > capacity)
+                return false;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            size_t offset = 0;
+            freed.wait(lock, [&]() { return stopping || fits(size, offset); });
+            if (stopping)
+                return false;
+
+            slot.id = firstId + allocations.size();
+            slot.offset = offset;
+            slot.data = mapped + offset;
+            allocations.push_back({offset, offset + size, nullptr, false});
+            head = offset + size;
+            return true;
+        }
+
+        // GL-потік, після команд, що читають ділянку. fence = 0 - ділянка не знадобилась
+        void release(const UploadSlot& slot, GLsync fence)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Allocation& allocation = allocations[slot.id - firstId];
+            allocation.fence = fence;
+            allocation.released = true;
+        }
+
+        // GL-потік, раз на кадр: повернути ділянки, прочитані GPU. Не блокує
+        void retire()
+        {
+            bool any = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while (!allocations.empty() && allocations.front().released)
+                {
+                    GLsync fence = allocations.front().fence;
+                    if (fence)
+                    {
+                        GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+                        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                            break;
+                        glDeleteSync(fence);
+                    }
+                    allocations.pop_front();
+                    firstId++;
+                    any = true;
+                }
+                if (allocations.empty())
+                    head = 0;
+            }
+            if (any)
+                freed.notify_all();
+        }
+
+        // Розбудити потоки, що чекають місця; нові виділення більше не вдаються
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            freed.notify_all();
+        }
+
+        ~UploadRing()
+        {
+            for (const Allocation& allocation : allocations)
+            {
+                if (allocation.fence)
+                    glDeleteSync(allocation.fence);
+            }
+            if (buffer != 0)
+            {
+                if (mapped)
+                {
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+                    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                }
+                glDeleteBuffers(1, &buffer);
+            }
+        }
+
+        UploadRing(const UploadRing&) = delete;
+        UploadRing& operator=(const UploadRing&) = delete;
+
+    private:
+        struct Allocation
+        {
+            size_t begin;
+            size_t end;
+            GLsync fence;
+            bool released;
+        };
+
+        // Зайняте - від початку найстарішої ділянки до head, можливо з переходом через кінець
+        bool fits(size_t size, size_t& offset) const
+        {
+            if (allocations.empty())
+            {
+                offset = 0;
+                return true;
+            }
+
+            size_t oldest = allocations.front().begin;
+            if (head > oldest)
+            {
+                if (capacity - head >= size)
+                {
+                    offset = head;
+                    return true;
+                }
+                // Хвіст буфера пропускаємо: наступна ділянка з нуля
+                if (oldest >= size)
+                {
+                    offset = 0;
+                    return true;
+                }
+                return false;
+            }
+            if (oldest - head >= size)
+            {
+                offset = head;
+                return true;
+            }
+            return false;
+        }
+
+        const size_t capacity;
+        unsigned char* mapped = nullptr;
+
+        std::mutex mutex;
+        std::condition_variable freed;
+        std::deque<Allocation> allocations;
+        uint64_t firstId = 0;
+        size_t head = 0;
+        bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <glm/glm.hpp>
+
+// Вершина у вихідному (нестиснутому) вигляді - так меші генеруються і зберігаються на CPU
+struct CubeVertex
+{
+    glm::vec3 position;
+    glm::vec3 color;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+};
+
+// Локації вершинних атрибутів (layout(location = N) у вершинних шейдерах)
+enum VertexAttribute
+{
+    ATTRIB_POSITION = 0,
+    ATTRIB_COLOR = 1,
+    ATTRIB_NORMAL = 2,
+    ATTRIB_TEXCOORD = 3,
+    ATTRIB_COUNT = 4
+};
+
+// Кодування компонентів для стиснутих форматів атрибутів (AttribFormat у vertex_layout.h)
+namespace VertexPacking
+{
+    // float -> IEEE half з округленням до найближчого (денормалі - до нуля)
+    inline uint16_t toHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        uint32_t sign = (bits >> 16) & 0x8000u;
+        int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFFu;
+
+        if (((bits >> 23) & 0xFF) == 0xFF)
+            return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+        if (exponent <= 0)
+            return static_cast<uint16_t>(sign);
+        if (exponent >= 31)
+            return static_cast<uint16_t>(sign | 0x7C00u);
+
+        uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        // Перенос у порядок при округленні коректний: 0x3FF + 1 переходить у наступний степінь
+        if ((mantissa & 0x1FFFu) > 0x1000u || ((mantissa & 0x1FFFu) == 0x1000u && (half & 1u)))
+            half++;
+        return static_cast<uint16_t>(half);
+    }
+
+    inline int16_t toSnorm16(float value)
+    {
+        return static_cast<int16_t>(std::lround(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    inline uint16_t toUnorm16(float value)
+    {
+        return static_cast<uint16_t>(std::lround(glm::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    // x, y, z - знакові 10 біт, w - 2 біти (GL_INT_2_10_10_10_REV, нормалізований)
+    inline uint32_t toInt2101010(const glm::vec3& value)
+    {
+        auto component = [](float v) {
+            return static_cast<uint32_t>(std::lround(glm::clamp(v, -1.0f, 1.0f) * 511.0f)) & 0x3FFu;
+        };
+        return component(value.x) | (component(value.y) << 10) | (component(value.z) << 20);
+    }
+
+    // Октаедрична проєкція одиничного вектора в [-1, 1]^2
+    inline glm::vec2 octEncode(glm::vec3 n)
+    {
+        n = n * (1.0f / (std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z)));
+        glm::vec2 e(n.x, n.y);
+        if (n.z < 0.0f)
+        {
+            e = glm::vec2((1.0f - std::fabs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                          (1.0f - std::fabs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+        }
+        return e;
+    }
+
+    template <typename T>
+    inline void write(unsigned char* dst, const T& value)
+    {
+        std::memcpy(dst, &value, sizeof(T));
+    }
+}
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+#include <glad/glad.h>
+#include <array>
+#include <vector>
+#include <utility>
+#include <tuple>
+#include <typeindex>
+#include <iostream>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "vertex_format.h"
+
+// Опис розкладки вершини на етапі компіляції:
+//   using Layout = VertexLayout<Attr<Semantic::Position, AttribFormat::Half4>, Attr<Semantic::Normal, AttribFormat::Snorm10x3>>;
+// Крок, зсуви і виклики glVertexAttrib*Pointer генеруються з типів; пакування - без розгалужень за форматом.
+
+// Формати атрибутів: як компонент лежить у буфері, як його кодувати з вихідного значення
+// і яким типом його має оголосити шейдер (glslType; w = 1 у Half4 / Unorm16x4 шейдер не читає)
+namespace AttribFormat
+{
+    struct Float3
+    {
+        static constexpr GLint components = 3;
+        static constexpr GLenum type = GL_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr bool integer = false;
+        static constexpr size_t size = 12;
+        static constexpr GLenum glslType = GL_FLOAT_VEC3;
+
+        static void encode(const glm::vec3& value, unsigned char* dst) { VertexPacking::write(dst, value); }
+    };
+
+    struct Float2
+    {
+        static constexpr GLint components = 2;
+        static constexpr GLenum type = GL_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr bool integer = false;
+        static constexpr size_t size = 8;
+        static constexpr GLenum glslType = GL_FLOAT_VEC2;
+
+        static void encode(const glm::vec2& value, unsigned char* dst) { VertexPacking::write(dst, value); }
+    };
+
+    // vec3 як 4 x half (w = 1)
+    struct Half4
+    {
+        static constexpr GLint components = 4;
+        static constexpr GLenum type = GL_HALF_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr bool integer = false;
+        static constexpr size_t size = 8;
+        static constexpr GLenum glslType = GL_FLOAT_VEC3;
+
+        static void encode(const glm::vec3& value, unsigned char* dst)
+        {
+            using VertexPacking::toHalf;
+            const uint16_t half[4] = {toHalf(value.x), toHalf(value.y), toHalf(value.z), toHalf(1.0f)};
+            VertexPacking::write(dst, half);
+        }
+    };
+
+    struct Half2
+    {
+        static constexpr GLint components = 2;
+        static constexpr GLenum type = GL_HALF_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr bool integer = false;
+        static constexpr size_t size = 4;
+        static constexpr GLenum glslType = GL_FLOAT_VEC2;
+
+        static void encode(const glm::vec2& value, unsigned char* dst)
+        {
+            using VertexPacking::toHalf;
+            const uint16_t half[2] = {toHalf(value.x), toHalf(value.y)};
+            VertexPacking::write(dst, half);
+        }
+    };
+
+    // vec3 у [0, 1] як 4 x unorm16 (w = 1); у простір об'єкта повертає матриця (ModelGeometry::decode)
+    struct Unorm16x4
+    {
+        static constexpr GLint components = 4;
+        static constexpr GLenum type = GL_UNSIGNED_SHORT;
+        static constexpr GLboolean normalized = GL_TRUE;
+        static constexpr bool integer = false;
+        static constexpr size_t size = 8;
+        static constexpr GLenum glslType = GL_FLOAT_VEC3;
+
+        static void encode(const glm::vec3& value, unsigned char* dst)
+        {
+            using VertexPacking::toUnorm16;
+            const uint16_t unorm[4] = {toUnorm16(value.x), toUnorm16(value.y), toUnorm16(value.z), 0xFFFF};
+            VertexPacking::write(dst, unorm);
+        }
+    };
+
+    // Одиничний вектор у GL_INT_2_10_10_10_REV
+    struct Snorm10x3
+    {
+        static constexpr GLint components = 4;
+        static constexpr GLenum type = GL_INT_2_10_10_10_REV;
+        static constexpr GLboolean normalized = GL_TRUE;
+        static constexpr bool integer = false;
+        static constexpr size_t size = 4;
+        static constexpr GLenum glslType = GL_FLOAT_VEC3;
+
+        static void encode(const glm::vec3& value, unsigned char* dst)
+        {
+            VertexPacking::write(dst, VertexPacking::toInt2101010(value));
+        }
+    };
+
+    // Одиничний вектор в октаедричному кодуванні (шейдер з OCTAHEDRAL_NORMALS)
+    struct OctSnorm16
+    {
+        static constexpr GLint components = 2;
+        static constexpr GLenum type = GL_SHORT;
+        static constexpr GLboolean normalized = GL_TRUE;
+        static constexpr bool integer = false;
+        static constexpr size_t size = 4;
+        static constexpr GLenum glslType = GL_FLOAT_VEC2;
+
+        static void encode(const glm::vec3& value, unsigned char* dst)
+        {
+            glm::vec2 e = VertexPacking::octEncode(value);
+            const int16_t snorm[2] = {VertexPacking::toSnorm16(e.x), VertexPacking::toSnorm16(e.y)};
+            VertexPacking::write(dst, snorm);
+        }
+    };
+
+    // uv у [0, 1]
+    struct Unorm16x2
+    {
+        static constexpr GLint components = 2;
+        static constexpr GLenum type = GL_UNSIGNED_SHORT;
+        static constexpr GLboolean normalized = GL_TRUE;
+        static constexpr bool integer = false;
+        static constexpr size_t size = 4;
+        static constexpr GLenum glslType = GL_FLOAT_VEC2;
+
+        static void encode(const glm::vec2& value, unsigned char* dst)
+        {
+            const uint16_t unorm[2] = {VertexPacking::toUnorm16(value.x), VertexPacking::toUnorm16(value.y)};
+            VertexPacking::write(dst, unorm);
+        }
+    };
+
+    // Цілочисельний атрибут (glVertexAttribIPointer)
+    struct Uint1
+    {
+        static constexpr GLint components = 1;
+        static constexpr GLenum type = GL_UNSIGNED_INT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr bool integer = true;
+        static constexpr size_t size = 4;
+        static constexpr GLenum glslType = GL_UNSIGNED_INT;
+
+        static void encode(unsigned int value, unsigned char* dst) { VertexPacking::write(dst, value); }
+    };
+}
+
+// Семантики: локація в шейдері та поле вихідної вершини
+namespace Semantic
+{
+    struct Position
+    {
+        static constexpr GLuint location = ATTRIB_POSITION;
+        static constexpr const char* name = "position";
+        static const glm::vec3& get(const CubeVertex& vertex) { return vertex.position; }
+    };
+
+    struct Color
+    {
+        static constexpr GLuint location = ATTRIB_COLOR;
+        static constexpr const char* name = "color";
+        static const glm::vec3& get(const CubeVertex& vertex) { return vertex.color; }
+    };
+
+    struct Normal
+    {
+        static constexpr GLuint location = ATTRIB_NORMAL;
+        static constexpr const char* name = "normal";
+        static const glm::vec3& get(const CubeVertex& vertex) { return vertex.normal; }
+    };
+
+    struct TexCoord
+    {
+        static constexpr GLuint location = ATTRIB_TEXCOORD;
+        static constexpr const char* name = "texCoord";
+        static const glm::vec2& get(const CubeVertex& vertex) { return vertex.texCoord; }
+    };
+}
+
+template <typename SemanticT, typename FormatT>
+struct Attr
+{
+    using Semantic = SemanticT;
+    using Format = FormatT;
+};
+
+template <typename... Attrs>
+struct VertexLayout
+{
+    static_assert(sizeof...(Attrs) > 0, "VertexLayout needs at least one attribute");
+
+    static constexpr size_t count = sizeof...(Attrs);
+    static constexpr GLsizei stride = static_cast<GLsizei>((Attrs::Format::size + ...));
+
+    // Зсуви атрибутів у порядку оголошення, без вирівнювання (усі формати кратні 4 байтам)
+    static constexpr std::array<size_t, count> offsets = []() {
+        constexpr size_t sizes[] = {Attrs::Format::size...};
+        std::array<size_t, count> result{};
+        size_t offset = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            result[i] = offset;
+            offset += sizes[i];
+        }
+        return result;
+    }();
+
+    static constexpr bool covers(GLuint location)
+    {
+        return ((Attrs::Semantic::location == location) || ...);
+    }
+
+    // Атрибути для прив'язаних VAO і GL_ARRAY_BUFFER; divisor 1 - дані інстансу
+    static void setup(GLuint divisor = 0)
+    {
+        setupEach(divisor, std::index_sequence_for<Attrs...>{});
+    }
+
+    // Пакування: Semantic::get(source) -> Format::encode для кожного атрибута
+    template <typename Source>
+    static std::vector<unsigned char> pack(const std::vector<Source>& source)
+    {
+        std::vector<unsigned char> data(source.size() * stride);
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            packEach(source[i], data.data() + i * stride, std::index_sequence_for<Attrs...>{});
+        }
+        return data;
+    }
+
+    // Перевірка проти лінкованої програми: кожен атрибут розкладки оголошений у шейдері саме
+    // тим типом, який дає формат (2_10_10_10 не підходить для vec2 октаедричної нормалі).
+    // Атрибут, який шейдер не читає, - лише попередження (зайва пропускна здатність)
+    static bool validate(const Shader& shader, const char* label)
+    {
+        bool valid = true;
+        (validateAttribute<Attrs>(shader, label, valid), ...);
+        return valid;
+    }
+
+    private:
+        template <size_t... I>
+        static void setupEach(GLuint divisor, std::index_sequence<I...>)
+        {
+            (setupAttribute<Attrs>(offsets[I], divisor), ...);
+        }
+
+        template <typename A>
+        static void setupAttribute(size_t offset, GLuint divisor)
+        {
+            using Format = typename A::Format;
+            const GLuint location = A::Semantic::location;
+
+            if constexpr (Format::integer)
+                glVertexAttribIPointer(location, Format::components, Format::type, stride, (void*)offset);
+            else
+                glVertexAttribPointer(location, Format::components, Format::type, Format::normalized, stride, (void*)offset);
+
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, divisor);
+        }
+
+        template <typename Source, size_t... I>
+        static void packEach(const Source& source, unsigned char* dst, std::index_sequence<I...>)
+        {
+            (Attrs::Format::encode(Attrs::Semantic::get(source), dst + offsets[I]), ...);
+        }
+
+        template <typename A>
+        static void validateAttribute(const Shader& shader, const char* label, bool& valid)
+        {
+            using Format = typename A::Format;
+            GLenum type = shader.attributeType(A::Semantic::location);
+            if (type == 0)
+            {
+                std::cout << "WARNING::VERTEX_LAYOUT::" << label << "::UNUSED_ATTRIBUTE " << A::Semantic::name << std::endl;
+                return;
+            }
+
+            if (type != Format::glslType)
+            {
+                std::cout << "ERROR::VERTEX_LAYOUT::" << label << "::TYPE_MISMATCH " << A::Semantic::name
+                          << ": shader 0x" << std::hex << type << ", layout 0x" << Format::glslType << std::dec
+                          << std::endl;
+                valid = false;
+            }
+        }
+};
+
+// Повна перевірка вершинного входу програми: кожна розкладка сумісна, і кожен активний
+// атрибут шейдера отримує дані хоча б з однієї розкладки (вершини, інстанси, ...).
+// Перевіряється й пишеться в журнал один раз на лінкування програми, далі - результат з Shader.
+// false - малювати з цією програмою не можна
+template <typename... Layouts>
+bool validateVertexInput(const Shader& shader, const char* label)
+{
+    const std::type_index layouts = typeid(std::tuple<Layouts...>);
+    bool valid = true;
+    if (shader.cachedVertexInput(layouts, valid))
+        return valid;
+
+    valid = (Layouts::validate(shader, label) & ...);
+
+    for (const auto& attribute : shader.attributes())
+    {
+        GLuint location = static_cast<GLuint>(attribute.first);
+        if (!(Layouts::covers(location) || ...))
+        {
+            std::cout << "ERROR::VERTEX_LAYOUT::" << label << "::MISSING_ATTRIBUTE location " << location << std::endl;
+            valid = false;
+        }
+    }
+    shader.cacheVertexInput(layouts, valid);
+    return valid;
+}
+
+#endif